@@ -1,3 +1,632 @@
+#define _GNU_SOURCE
 #include "back.h"
 
+#include <time.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
+#define JOURNAL_ENV      "FT_JOURNAL"
+#define JOURNAL_DEFAULT  ".4T.journal"
+
+/* The index is a sidecar file next to the journal holding an open
+ * addressing table keyed by (task, day), the hash only picks the slot. Besides the per day
+ * entries every task has an 'all days' entry and every day has an
+ * 'all tasks' one, so any query is a handful of probes
+ */
+#define INDEX_SUFFIX     ".idx"
+#define INDEX_MAGIC      0x34544958u
+#define INDEX_VERSION    3
+#define INDEX_MIN_CAP    256
+
+#define ALL_TASKS        0u
+#define ALL_DAYS         INT32_MIN
+
+#define SECS_PER_DAY     86400
+
+#define SNAP_SUFFIX      ".snap"
+
+struct idx_header
+{
+	uint32_t magic, version;
+	/* journal bytes already accounted for */
+	uint64_t offset;
+	uint32_t cap, used;
+};
+
+struct idx_slot
+{
+	uint32_t task;
+	int32_t  day;
+	uint64_t seconds;
+	uint32_t sessions, used;
+	char     name[BACK_TASK_SIZE];
+};
+
+struct index
+{
+	struct idx_header *hdr;
+	struct idx_slot   *slots;
+	size_t            size;
+	int               fd;
+};
+
+_Static_assert(sizeof(struct record) == 128, "journal records must stay 128 bytes long");
+
+static bool_t index_open (struct index*, const bool_t);
+static void index_close (struct index*);
+static void index_catch_up (struct index*);
+
+static uint32_t crc32 (const void *data, const size_t len)
+{
+	static uint32_t table[256];
+	static bool_t   ready = FALSE;
+
+	if (!ready)
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t c = i;
+			for (unsigned short k = 0; k < 8; k++) { c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1; }
+			table[i] = c;
+		}
+		ready = TRUE;
+	}
+
+	const unsigned char *bytes = (const unsigned char*) data;
+	uint32_t crc = 0xffffffffu;
+
+	for (size_t i = 0; i < len; i++) { crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8); }
+	return crc ^ 0xffffffffu;
+}
+
+static inline uint32_t record_crc (const struct record *rec)
+{
+	return crc32(rec, offsetof(struct record, crc));
+}
+
+static void flush_batch (struct journal *jr)
+{
+	if (jr->pending == 0) return;
+
+	/* O_APPEND makes the kernel pick the offset and write the
+	 * whole batch at once, other 4T processes cannot interleave.
+	 * A failed write cannot be recovered from here, the batch is
+	 * dropped and a short one is caught by the checksum later on
+	 */
+	if (write(jr->fd, jr->batch, jr->pending * sizeof(struct record)) > 0 && jr->snap)
+	{
+		jr->snap->recorded  = jr->batch[jr->pending - 1].worked;
+		jr->snap->journaled = TRUE;
+	}
+	jr->pending = 0;
+}
+
+const char *backend_journal_path (void)
+{
+	static char path[4096];
+
+	const char *env = getenv(JOURNAL_ENV);
+	if (env && *env) return env;
+
+	const char *home = getenv("HOME");
+	snprintf(path, sizeof(path), "%s/%s", home ? home : ".", JOURNAL_DEFAULT);
+	return path;
+}
+
+void backend_session (struct record *proto, const char *task, const char *font, const unsigned int total)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+
+	memset(proto, 0, sizeof(*proto));
+	proto->magic   = BACK_RECORD_MAGIC;
+	proto->version = BACK_RECORD_VER;
+	proto->session = ((uint64_t) now.tv_sec * 1000000000u + now.tv_nsec) ^ ((uint64_t) getpid() << 48);
+	proto->start   = now.tv_sec;
+	proto->total   = total;
+	proto->flags   = BACK_RECORD_OPENS;
+
+	strncpy(proto->task, task, BACK_TASK_SIZE - 1);
+	strncpy(proto->font, font, BACK_FONT_SIZE - 1);
+}
+
+static void snapshot_session (struct record *proto, const struct snapshot *snap)
+{
+	/* same session as before, the first record carries whatever
+	 * the journal missed (a checkpoint still batched, for one)
+	 */
+	memset(proto, 0, sizeof(*proto));
+	proto->magic   = BACK_RECORD_MAGIC;
+	proto->version = BACK_RECORD_VER;
+	proto->session = snap->session;
+	proto->start   = snap->start;
+	proto->total   = snap->total;
+	proto->worked  = snap->recorded;
+	/* its opening record may have been lost in the batch */
+	proto->flags   = snap->journaled ? 0 : BACK_RECORD_OPENS;
+
+	memcpy(proto->task, snap->task, BACK_TASK_SIZE);
+	strncpy(proto->font, snap->font, BACK_FONT_SIZE - 1);
+}
+
+bool_t backend_open (struct journal *jr, const char *task, const char *font, const unsigned int total, struct snapshot *snap)
+{
+	memset(jr, 0, sizeof(*jr));
+	jr->snap = snap;
+	jr->fd   = open(backend_journal_path(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+	/* a session still resumable (killed, never resumed) is about to
+	 * be forgotten, whatever the journal missed of it is saved first
+	 */
+	if (snap && snap->resumable && snap->worked > snap->recorded)
+	{
+		struct record lost;
+		snapshot_session(&lost, snap);
+		backend_append(jr, &lost, reason_lost, snap->worked, snap->pauses, snap->paused);
+		flush_batch(jr);
+	}
+
+	backend_session(&jr->proto, task, font, total);
+
+	if (snap)
+	{
+		/* a font whose name does not fit could not be found again */
+		const size_t fontlen = strlen(font);
+
+		*snap = (struct snapshot) {
+			.magic     = BACK_SNAP_MAGIC,
+			.version   = BACK_SNAP_VER,
+			.session   = jr->proto.session,
+			.start     = jr->proto.start,
+			.total     = total,
+			.resumable = fontlen < sizeof(snap->font)
+		};
+		memcpy(snap->task, jr->proto.task, BACK_TASK_SIZE);
+		if (snap->resumable) memcpy(snap->font, font, fontlen + 1);
+	}
+
+	return jr->fd != -1;
+}
+
+bool_t backend_resume (struct journal *jr, struct snapshot *snap)
+{
+	memset(jr, 0, sizeof(*jr));
+	jr->snap = snap;
+
+	snapshot_session(&jr->proto, snap);
+
+	jr->fd = open(backend_journal_path(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	return jr->fd != -1;
+}
+
+bool_t backend_attach (struct journal *jr)
+{
+	memset(jr, 0, sizeof(*jr));
+
+	jr->fd = open(backend_journal_path(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	return jr->fd != -1;
+}
+
+void backend_append (struct journal *jr, struct record *proto, const enum reason reason, const unsigned int worked, const unsigned int pauses, const unsigned int paused)
+{
+	if (jr->fd == -1) return;
+
+	struct record *rec = &jr->batch[jr->pending++];
+	*rec = *proto;
+
+	rec->reason = (uint8_t) reason;
+	rec->stamp  = time(NULL);
+	rec->delta  = worked - proto->worked;
+	rec->worked = worked;
+	rec->pauses = pauses;
+	rec->paused = paused;
+	rec->crc    = record_crc(rec);
+
+	proto->worked = worked;
+	proto->flags &= (uint8_t) ~BACK_RECORD_OPENS;
+
+	if (jr->pending == BACK_BATCH_SIZE) { flush_batch(jr); }
+}
+
+void backend_record (struct journal *jr, const enum reason reason, const unsigned int worked, const unsigned int pauses, const unsigned int paused)
+{
+	if (jr->fd == -1) return;
+
+	backend_append(jr, &jr->proto, reason, worked, pauses, paused);
+
+	backend_snapshot_update(jr->snap, worked, pauses, paused);
+	if (jr->snap && reason == reason_done) { jr->snap->resumable = FALSE; }
+
+	if (reason != reason_checkpoint) { flush_batch(jr); }
+}
+
+void backend_set_total (struct journal *jr, const unsigned int total)
+{
+	/* only records from now on carry it */
+	jr->proto.total = total;
+	if (jr->snap) jr->snap->total = total;
+}
+
+void backend_close (struct journal *jr)
+{
+	if (jr->fd == -1) return;
+
+	backend_sync(jr);
+	close(jr->fd);
+
+	jr->fd = -1;
+}
+
+void backend_sync (struct journal *jr)
+{
+	if (jr->fd == -1) return;
+
+	flush_batch(jr);
+	fdatasync(jr->fd);
+
+	/* the index is kept up to date here and never while ticking, it
+	 * picks up whatever other processes appended as well. When some
+	 * other process holds it, that one (or the next --stats) does it
+	 */
+	struct index idx;
+	if (index_open(&idx, FALSE))
+	{
+		index_catch_up(&idx);
+		index_close(&idx);
+	}
+}
+
+bool_t backend_next (const char *data, const size_t len, size_t *off, struct record *rec)
+{
+	/* a record torn by a crash fails the checksum (or is simply too
+	 * short), the scan then slides byte by byte until it finds the
+	 * next record which is valid, anything in between is skipped
+	 */
+	while (*off + sizeof(struct record) <= len)
+	{
+		memcpy(rec, data + *off, sizeof(struct record));
+
+		if (rec->magic == BACK_RECORD_MAGIC && rec->version && rec->version <= BACK_RECORD_VER && rec->crc == record_crc(rec))
+		{
+			*off += sizeof(struct record);
+			return TRUE;
+		}
+
+		const uint32_t magic = BACK_RECORD_MAGIC;
+		const char *next = (const char*) memmem(data + *off + 1, len - *off - 1, &magic, sizeof(magic));
+
+		*off = next ? (size_t) (next - data) : len;
+	}
+
+	return FALSE;
+}
+
+bool_t backend_snapshot_open (struct snapshot_map *map)
+{
+	char path[4096];
+	snprintf(path, sizeof(path), "%s%s", backend_journal_path(), SNAP_SUFFIX);
+
+	map->snap = NULL;
+	if ((map->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644)) == -1) return FALSE;
+
+	/* somebody else's session owns it */
+	if (flock(map->fd, LOCK_EX | LOCK_NB) == -1 || ftruncate(map->fd, sizeof(struct snapshot)) == -1) goto fail;
+
+	void *data = mmap(NULL, sizeof(struct snapshot), PROT_READ | PROT_WRITE, MAP_SHARED, map->fd, 0);
+	if (data == MAP_FAILED) goto fail;
+
+	map->snap = (struct snapshot*) data;
+
+	/* anything unknown (new file, older layout) is nothing to resume */
+	if (map->snap->magic != BACK_SNAP_MAGIC || map->snap->version != BACK_SNAP_VER)
+	{
+		memset(map->snap, 0, sizeof(struct snapshot));
+	}
+	return TRUE;
+
+fail:
+	close(map->fd);
+	map->fd = -1;
+	return FALSE;
+}
+
+void backend_snapshot_close (struct snapshot_map *map)
+{
+	if (map->snap) munmap(map->snap, sizeof(struct snapshot));
+	if (map->fd != -1) close(map->fd);
+
+	map->snap = NULL;
+	map->fd   = -1;
+}
+
+static inline uint32_t task_hash (const char *name)
+{
+	uint32_t hash = 2166136261u;
+	for (; *name; name++)
+	{
+		hash ^= (unsigned char) *name;
+		hash *= 16777619u;
+	}
+	return hash == ALL_TASKS ? 1 : hash;
+}
+
+static inline int32_t day_of (const int64_t stamp)
+{
+	/* days are local ones, a session at 23:30 belongs to that day */
+	struct tm tm;
+	const time_t t = (time_t) stamp;
+	localtime_r(&t, &tm);
+
+	const int64_t local = stamp + tm.tm_gmtoff;
+	return (int32_t) ((local - (((local % SECS_PER_DAY) + SECS_PER_DAY) % SECS_PER_DAY)) / SECS_PER_DAY);
+}
+
+static inline int32_t week_of (const int32_t day)
+{
+	/* 1970-01-01 was a Thursday, weeks start on Monday */
+	return day - (((day + 3) % 7) + 7) % 7;
+}
+
+static inline size_t index_size (const uint32_t cap)
+{
+	return sizeof(struct idx_header) + (size_t) cap * sizeof(struct idx_slot);
+}
+
+static bool_t index_map (struct index *idx, const uint32_t cap)
+{
+	idx->size = index_size(cap);
+	void *map = mmap(NULL, idx->size, PROT_READ | PROT_WRITE, MAP_SHARED, idx->fd, 0);
+
+	if (map == MAP_FAILED) return FALSE;
+
+	idx->hdr   = (struct idx_header*) map;
+	idx->slots = (struct idx_slot*) (idx->hdr + 1);
+	return TRUE;
+}
+
+static bool_t index_reset (struct index *idx, const uint32_t cap)
+{
+	if (idx->hdr) munmap(idx->hdr, idx->size);
+	idx->hdr = NULL;
+
+	/* truncating to zero first drops every previous slot */
+	if (ftruncate(idx->fd, 0) == -1 || ftruncate(idx->fd, index_size(cap)) == -1 || !index_map(idx, cap)) return FALSE;
+
+	idx->hdr->magic   = INDEX_MAGIC;
+	idx->hdr->version = INDEX_VERSION;
+	idx->hdr->cap     = cap;
+	return TRUE;
+}
+
+static bool_t index_open (struct index *idx, const bool_t wait)
+{
+	char path[4096];
+	snprintf(path, sizeof(path), "%s%s", backend_journal_path(), INDEX_SUFFIX);
+
+	memset(idx, 0, sizeof(*idx));
+	if ((idx->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644)) == -1) return FALSE;
+
+	/* several 4T processes may be updating it at the same time */
+	struct stat st;
+	if (flock(idx->fd, wait ? LOCK_EX : LOCK_EX | LOCK_NB) == -1 || fstat(idx->fd, &st) == -1) goto fail;
+
+	if ((size_t) st.st_size >= sizeof(struct idx_header))
+	{
+		struct idx_header hdr;
+		if (pread(idx->fd, &hdr, sizeof(hdr), 0) == sizeof(hdr) && hdr.magic == INDEX_MAGIC &&
+		    hdr.version == INDEX_VERSION && hdr.cap && (size_t) st.st_size == index_size(hdr.cap) &&
+		    index_map(idx, hdr.cap))
+		{
+			return TRUE;
+		}
+	}
+
+	if (index_reset(idx, INDEX_MIN_CAP)) return TRUE;
+
+fail:
+	close(idx->fd);
+	return FALSE;
+}
+
+static void index_close (struct index *idx)
+{
+	if (idx->hdr) munmap(idx->hdr, idx->size);
+	close(idx->fd);
+}
+
+static inline uint32_t slot_of (const uint32_t task, const int32_t day, const uint32_t cap)
+{
+	uint32_t h = task ^ ((uint32_t) day * 2654435761u);
+	h ^= h >> 16;
+	return h & (cap - 1);
+}
+
+static struct idx_slot *index_find (const struct index *idx, const uint32_t task, const char *name, const int32_t day)
+{
+	const uint32_t cap = idx->hdr->cap;
+
+	/* two tasks may share a hash, only the name tells them apart */
+	for (uint32_t i = slot_of(task, day, cap), n = 0; n < cap; i = (i + 1) & (cap - 1), n++)
+	{
+		struct idx_slot *slot = &idx->slots[i];
+		if (!slot->used) return slot;
+		if (slot->task == task && slot->day == day && !strncmp(slot->name, name, BACK_TASK_SIZE)) return slot;
+	}
+
+	return NULL;
+}
+
+static void index_grow (struct index *idx)
+{
+	const uint32_t cap = idx->hdr->cap;
+	const uint64_t off = idx->hdr->offset;
+
+	struct idx_slot *old = (struct idx_slot*) malloc((size_t) cap * sizeof(struct idx_slot));
+	if (old == NULL) return;
+
+	memcpy(old, idx->slots, (size_t) cap * sizeof(struct idx_slot));
+
+	if (index_reset(idx, cap << 1))
+	{
+		idx->hdr->offset = off;
+		for (uint32_t i = 0; i < cap; i++)
+		{
+			if (!old[i].used) continue;
+
+			*index_find(idx, old[i].task, old[i].name, old[i].day) = old[i];
+			idx->hdr->used++;
+		}
+	}
+
+	free(old);
+}
+
+static void index_add (struct index *idx, const uint32_t task, const int32_t day, const struct record *rec)
+{
+	if ((idx->hdr->used + 1) * 4 >= idx->hdr->cap * 3) index_grow(idx);
+	if (idx->hdr == NULL) return;
+
+	const char *name = task == ALL_TASKS ? "" : rec->task;
+
+	/* a full table whose growth failed takes nothing more */
+	struct idx_slot *slot = index_find(idx, task, name, day);
+	if (slot == NULL) return;
+
+	if (!slot->used)
+	{
+		slot->used = 1;
+		slot->task = task;
+		slot->day  = day;
+		strncpy(slot->name, name, BACK_TASK_SIZE - 1);
+		idx->hdr->used++;
+	}
+
+	/* version 1 only tells when a run ends, which a resumed session
+	 * does once more
+	 */
+	slot->seconds  += rec->delta;
+	slot->sessions += rec->version == 1 ? rec->reason != reason_checkpoint : (rec->flags & BACK_RECORD_OPENS) != 0;
+}
+
+static void index_catch_up (struct index *idx)
+{
+	const int fd = open(backend_journal_path(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1) return;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size == 0)
+	{
+		close(fd);
+		return;
+	}
+
+	/* a journal smaller than what was indexed has been replaced */
+	if ((uint64_t) st.st_size < idx->hdr->offset && !index_reset(idx, INDEX_MIN_CAP))
+	{
+		close(fd);
+		return;
+	}
+
+	const size_t len = (size_t) st.st_size;
+	const char *map  = (const char*) mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED) return;
+
+	/* only the tail which was not indexed yet is ever touched, the
+	 * offset only moves past valid records so a record still being
+	 * written is picked up next time
+	 */
+	size_t off = idx->hdr->offset;
+	struct record rec;
+
+	while (backend_next(map, len, &off, &rec))
+	{
+		const uint32_t task = task_hash(rec.task);
+		const int32_t  day  = day_of(rec.stamp);
+
+		index_add(idx, task, day, &rec);
+		index_add(idx, task, ALL_DAYS, &rec);
+		index_add(idx, ALL_TASKS, day, &rec);
+
+		if (idx->hdr == NULL) break;
+		idx->hdr->offset = off;
+	}
+
+	munmap((void*) map, len);
+}
+
+static void print_duration (const char *label, const uint64_t secs, const uint32_t sessions)
+{
+	printf("  %-24s %4luh %02lum %02lus", label, (unsigned long) (secs / 3600), (unsigned long) (secs / 60 % 60), (unsigned long) (secs % 60));
+	if (sessions) printf("  (%u session%s)", sessions, sessions == 1 ? "" : "s");
+	putchar('\n');
+}
+
+static uint64_t seconds_at (const struct index *idx, const uint32_t task, const char *name, const int32_t day)
+{
+	const struct idx_slot *slot = index_find(idx, task, name, day);
+	return slot && slot->used ? slot->seconds : 0;
+}
+
+void backend_print_stats (const char *task)
+{
+	struct index idx;
+	if (!index_open(&idx, TRUE))
+	{
+		fprintf(stderr, "%s: error: cannot open the journal index\n", PROGRAM_NAME);
+		return;
+	}
+
+	index_catch_up(&idx);
+	if (idx.hdr == NULL)
+	{
+		index_close(&idx);
+		return;
+	}
+
+	/* the journal only keeps that much of a name */
+	char name[BACK_TASK_SIZE] = "";
+	if (task) strncpy(name, task, BACK_TASK_SIZE - 1);
+
+	const uint32_t key   = *name ? task_hash(name) : ALL_TASKS;
+	const int32_t  today = day_of(time(NULL));
+	char label[32];
+
+	printf("%s - worked time%s%s\n", PROGRAM_NAME, key == ALL_TASKS ? "" : " on ", key == ALL_TASKS ? "" : task);
+
+	printf(" per task\n");
+	for (uint32_t i = 0; i < idx.hdr->cap; i++)
+	{
+		const struct idx_slot *slot = &idx.slots[i];
+		if (!slot->used || slot->day != ALL_DAYS || (key != ALL_TASKS && (slot->task != key || strcmp(slot->name, name)))) continue;
+		print_duration(slot->name, slot->seconds, slot->sessions);
+	}
+
+	printf(" last %d days\n", BACK_STATS_DAYS);
+	for (int32_t day = today - BACK_STATS_DAYS + 1; day <= today; day++)
+	{
+		const time_t t = (time_t) day * SECS_PER_DAY;
+		strftime(label, sizeof(label), "%Y-%m-%d %a", gmtime(&t));
+		print_duration(label, seconds_at(&idx, key, name, day), 0);
+	}
+
+	printf(" last %d weeks\n", BACK_STATS_WEEKS);
+	for (int32_t week = week_of(today) - (BACK_STATS_WEEKS - 1) * 7; week <= today; week += 7)
+	{
+		uint64_t secs = 0;
+		for (int32_t day = week; day < week + 7; day++) { secs += seconds_at(&idx, key, name, day); }
+
+		const time_t t = (time_t) week * SECS_PER_DAY;
+		strftime(label, sizeof(label), "week of %Y-%m-%d", gmtime(&t));
+		print_duration(label, secs, 0);
+	}
+
+	index_close(&idx);
+}
@@ -1,4 +1,143 @@
 #ifndef FT_BACK_H
 #define FT_BACK_H
 
+#include "common.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+
+#define BACK_TASK_SIZE     48
+#define BACK_FONT_SIZE     24
+
+/* Records kept in memory before they are handed to the kernel
+ * with a single write, the journal only gets synced on close
+ */
+#define BACK_BATCH_SIZE    4
+
+#define BACK_RECORD_MAGIC  0x34544a52u
+#define BACK_RECORD_VER    2
+
+/* record.flags, version 1 records carry none and are still read (a
+ * session of theirs is counted by its closing record instead)
+ */
+#define BACK_RECORD_OPENS  0x01
+
+/* Why a record was written, anything but 'checkpoint' closes
+ * the session
+ */
+enum reason
+{
+	reason_checkpoint = 0,
+	reason_done       = 1,
+	reason_quit       = 2,
+	reason_small      = 3,
+	reason_hangup     = 4,
+	/* never resumed, closed by the next session on its behalf */
+	reason_lost       = 5,
+};
+
+/* Fixed-size journal entry, 'delta' are the seconds worked since
+ * the previous record of the very same session so adding up every
+ * record of a task never counts a second twice, likewise only the
+ * first record of a session is flagged as opening it
+ */
+struct record
+{
+	uint32_t magic;
+	uint16_t version;
+	uint8_t  reason;
+	uint8_t  flags;
+	uint64_t session;
+	int64_t  start, stamp;
+	uint32_t delta, worked, total;
+	uint32_t pauses, paused;
+	char     task[BACK_TASK_SIZE];
+	char     font[BACK_FONT_SIZE];
+	uint32_t crc;
+};
+
+#define BACK_SNAP_MAGIC    0x34545350u
+#define BACK_SNAP_VER      2
+
+/* Live state of the running session, mapped shared from a sidecar
+ * file so updating it is a plain store (the kernel writes it back,
+ * even if the process gets killed). 'recorded' is what the journal
+ * already holds, a resumed session only appends what is missing
+ */
+struct snapshot
+{
+	uint32_t magic, version;
+	uint64_t session;
+	int64_t  start;
+	uint32_t total, worked, recorded;
+	uint32_t pauses, paused;
+	/* the session can be continued: it did not run to its end */
+	uint32_t resumable;
+	/* some record of the session made it to the journal already */
+	uint32_t journaled;
+	char     task[BACK_TASK_SIZE];
+	/* whole name, a FIGlet font is a path (records keep a prefix) */
+	char     font[PATH_MAX];
+};
+
+/* The snapshot file is locked as long as it is mapped, only one
+ * session at a time gets to be resumable
+ */
+struct snapshot_map
+{
+	struct snapshot *snap;
+	int             fd;
+};
+
+struct journal
+{
+	struct record   batch[BACK_BATCH_SIZE];
+	/* fields shared by every record of the session */
+	struct record   proto;
+	unsigned short  pending;
+	int             fd;
+	/* kept in sync with the records, may be NULL */
+	struct snapshot *snap;
+};
+
+const char *backend_journal_path (void);
+
+bool_t backend_open (struct journal*, const char*, const char*, const unsigned int, struct snapshot*);
+bool_t backend_resume (struct journal*, struct snapshot*);
+void backend_record (struct journal*, const enum reason, const unsigned int, const unsigned int, const unsigned int);
+void backend_set_total (struct journal*, const unsigned int);
+void backend_sync (struct journal*);
+void backend_close (struct journal*);
+
+/* A journal with no session of its own (the daemon's): records of
+ * any number of sessions share its batch, 'proto' being the session
+ * each one belongs to (see backend_session). Nothing reaches the disk
+ * until the batch fills up or backend_sync is called
+ */
+void backend_session (struct record*, const char*, const char*, const unsigned int);
+bool_t backend_attach (struct journal*);
+void backend_append (struct journal*, struct record*, const enum reason, const unsigned int, const unsigned int, const unsigned int);
+
+bool_t backend_next (const char*, const size_t, size_t*, struct record*);
+
+bool_t backend_snapshot_open (struct snapshot_map*);
+void backend_snapshot_close (struct snapshot_map*);
+
+static inline void backend_snapshot_update (struct snapshot *snap, const unsigned int worked, const unsigned int pauses, const unsigned int paused)
+{
+	if (snap == NULL) return;
+
+	snap->worked = worked;
+	snap->pauses = pauses;
+	snap->paused = paused;
+}
+
+/* Days of history and weeks reported by backend_print_stats
+ */
+#define BACK_STATS_DAYS    7
+#define BACK_STATS_WEEKS   4
+
+void backend_print_stats (const char*);
+
 #endif
@@ -0,0 +1,260 @@
+#define _GNU_SOURCE
+
+#include "common.h"
+#include "render.h"
+#include "status.h"
+#include "tick.h"
+
+#include <spawn.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/wait.h>
+
+/* Headless rendering benchmark: every built-in font is driven through
+ * steady ticks and resize storms, the bytes end up either nowhere
+ * (pure composing + encoding cost) or in a pseudo-terminal drained by
+ * a child process (what a real terminal costs us in syscalls)
+ *
+ * Then the status path: reading a live status page and a whole
+ * '4T --status' process (when the binary is given as argument)
+ */
+#define BENCH_TICKS            3600
+#define BENCH_RESIZES          400
+#define BENCH_READS            100000
+#define BENCH_QUERIES          500
+
+struct size
+{
+	unsigned short height, width;
+};
+
+struct sink
+{
+	const char *name;
+	int        fd;
+};
+
+struct scenario
+{
+	const char *name;
+	void       (*frame) (struct render*, const struct size*, const unsigned int);
+};
+
+static const struct size Sizes[] =
+{
+	{ 24,  80 },
+	{ 50, 160 },
+	{ 60, 240 },
+};
+
+static int open_pty (pid_t*);
+static void close_pty (const int, const pid_t);
+
+static void steady_frame (struct render*, const struct size*, const unsigned int);
+static void storm_frame (struct render*, const struct size*, const unsigned int);
+static void run_case (const struct font_entry*, const struct size*, const struct scenario*, const struct sink*);
+
+static void bench_status (const char*);
+static int64_t spawn_status (const char*);
+static void report_status (const char*, int64_t*, const unsigned int, const double);
+
+static int cmp_ns (const void*, const void*);
+
+extern char **environ;
+
+int main (int argc, char **argv)
+{
+	pid_t drainer = -1;
+	const struct sink sinks[] =
+	{
+		{ "null", FRAME_NO_FD       },
+		{ "pty",  open_pty(&drainer) },
+	};
+	const struct scenario scenarios[] =
+	{
+		{ "steady", steady_frame },
+		{ "storm",  storm_frame  },
+	};
+
+	printf("%-11s %-8s %-7s %-5s %10s %9s %9s %9s %9s\n", "font", "size", "case", "sink", "fps", "B/frame", "sys/frame", "p50 us", "p99 us");
+
+	for (unsigned short i = 0; i < NoFonts; i++)
+		for (unsigned short s = 0; s < sizeof(Sizes) / sizeof(Sizes[0]); s++)
+			for (unsigned short c = 0; c < sizeof(scenarios) / sizeof(scenarios[0]); c++)
+				for (unsigned short k = 0; k < sizeof(sinks) / sizeof(sinks[0]); k++)
+				{
+					if (sinks[k].fd == -1 && k) continue;
+					run_case(&FontTable[i], &Sizes[s], &scenarios[c], &sinks[k]);
+				}
+
+	if (sinks[1].fd != -1) close_pty(sinks[1].fd, drainer);
+
+	bench_status(argc > 1 ? argv[1] : NULL);
+	return EXIT_SUCCESS;
+}
+
+static int open_pty (pid_t *drainer)
+{
+	const int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master == -1 || grantpt(master) == -1 || unlockpt(master) == -1)
+	{
+		fprintf(stderr, "%s: warning: no pseudo-terminal available, pty sink skipped\n", PROGRAM_NAME);
+		return -1;
+	}
+
+	const int slave = open(ptsname(master), O_WRONLY | O_NOCTTY);
+	if (slave == -1) { close(master); return -1; }
+
+	/* same line discipline the timer sets up on its own terminal */
+	struct termios tty;
+	tcgetattr(slave, &tty);
+	cfmakeraw(&tty);
+	tcsetattr(slave, TCSANOW, &tty);
+
+	/* the terminal side: reads everything as fast as it comes */
+	if ((*drainer = fork()) == 0)
+	{
+		static char buf[1 << 16];
+		close(slave);
+		while (read(master, buf, sizeof(buf)) > 0);
+		_exit(EXIT_SUCCESS);
+	}
+
+	close(master);
+	return slave;
+}
+
+static void close_pty (const int slave, const pid_t drainer)
+{
+	close(slave);
+	kill(drainer, SIGTERM);
+	waitpid(drainer, NULL, 0);
+}
+
+static void steady_frame (struct render *r, const struct size *size, const unsigned int n)
+{
+	if (n == 0) render_layout(r, size->height, size->width);
+	render_time(r, n);
+}
+
+static void storm_frame (struct render *r, const struct size *size, const unsigned int n)
+{
+	/* the window keeps being dragged back and forth by one column */
+	render_layout(r, size->height, size->width - (n & 1));
+	render_time(r, n);
+}
+
+static void run_case (const struct font_entry *entry, const struct size *size, const struct scenario *scenario, const struct sink *sink)
+{
+	const struct font_t *font = entry->font;
+	if (font->width * RENDER_CHARSET_SIZE + 1 >= size->width || font->height + EXTRA_RENDERED_LINES >= size->height) return;
+
+	const unsigned int frames = scenario->frame == storm_frame ? BENCH_RESIZES : BENCH_TICKS;
+	int64_t *ns = (int64_t*) malloc(frames * sizeof(int64_t));
+	if (ns == NULL)
+	{
+		fprintf(stderr, "%s: error: out of memory\n", PROGRAM_NAME);
+		exit(EXIT_FAILURE);
+	}
+
+	struct render r = { .font = font, .task = "benchmark" };
+	const int64_t begin = tick_now();
+
+	for (unsigned int n = 0; n < frames; n++)
+	{
+		const int64_t t0 = tick_now();
+		scenario->frame(&r, size, n);
+		frame_flush(&r.frame, sink->fd);
+		ns[n] = tick_now() - t0;
+	}
+
+	const double secs = (double) (tick_now() - begin) / NS_PER_SEC;
+	qsort(ns, frames, sizeof(int64_t), cmp_ns);
+
+	char dims[16];
+	snprintf(dims, sizeof(dims), "%ux%u", size->height, size->width);
+
+	printf("%-11s %-8s %-7s %-5s %10.0f %9.1f %9.2f %9.2f %9.2f\n", entry->name, dims, scenario->name, sink->name,
+	       frames / secs,
+	       (double) r.frame.bytes  / r.frame.frames,
+	       (double) r.frame.writes / r.frame.frames,
+	       ns[frames / 2] / 1e3,
+	       ns[frames * 99 / 100] / 1e3);
+
+	render_free(&r);
+	free(ns);
+}
+
+static void bench_status (const char *binary)
+{
+	/* the bench itself plays the running timer */
+	struct status_map map;
+	if (!status_open(&map))
+	{
+		fprintf(stderr, "%s: warning: no status page available, status bench skipped\n", PROGRAM_NAME);
+		return;
+	}
+	status_publish(&map, "benchmark", status_working, 754, 1800);
+
+	const unsigned int runs = binary ? BENCH_QUERIES : 0;
+	int64_t *ns = (int64_t*) malloc((BENCH_READS > runs ? BENCH_READS : runs) * sizeof(int64_t));
+	if (ns == NULL)
+	{
+		fprintf(stderr, "%s: error: out of memory\n", PROGRAM_NAME);
+		exit(EXIT_FAILURE);
+	}
+
+	printf("\n%-24s %10s %9s %9s\n", "status", "per sec", "p50 us", "p99 us");
+
+	struct status_page copy;
+	int64_t begin = tick_now();
+	for (unsigned int n = 0; n < BENCH_READS; n++)
+	{
+		const int64_t t0 = tick_now();
+		status_read(map.page, &copy);
+		ns[n] = tick_now() - t0;
+	}
+	report_status("seqlock read", ns, BENCH_READS, (double) (tick_now() - begin) / NS_PER_SEC);
+
+	/* startup included: exec, dynamic linking, flags, the lookup */
+	begin = tick_now();
+	for (unsigned int n = 0; n < runs; n++) ns[n] = spawn_status(binary);
+	if (runs) report_status("4T --status (process)", ns, runs, (double) (tick_now() - begin) / NS_PER_SEC);
+
+	status_close(&map);
+	free(ns);
+}
+
+static int64_t spawn_status (const char *binary)
+{
+	char *const args[] = { (char*) binary, "--status", NULL };
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+	pid_t pid;
+	const int64_t t0 = tick_now();
+	if (posix_spawn(&pid, binary, &actions, NULL, args, environ) == 0) waitpid(pid, NULL, 0);
+	const int64_t took = tick_now() - t0;
+
+	posix_spawn_file_actions_destroy(&actions);
+	return took;
+}
+
+static void report_status (const char *name, int64_t *ns, const unsigned int n, const double secs)
+{
+	qsort(ns, n, sizeof(int64_t), cmp_ns);
+	printf("%-24s %10.0f %9.2f %9.2f\n", name, n / secs, ns[n / 2] / 1e3, ns[n * 99 / 100] / 1e3);
+}
+
+static int cmp_ns (const void *a, const void *b)
+{
+	const int64_t x = *(const int64_t*) a, y = *(const int64_t*) b;
+	return (x > y) - (x < y);
+}
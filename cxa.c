@@ -2,27 +2,22 @@
 #include <ctype.h>
 #include <errno.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
 #include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define MAX(a, b)   ((a) > (b) ? (a) : (b))
 
-/* Refers to the name of the major project which is making use of the
- * library, set on 'cxa_execute' function
+/* Context used by the non reentrant entry points (cxa_execute and
+ * cxa_print_usage), anything else gets its own from the caller
  */
-static char *Project = "unnamed";
-
-/* Refers to the last flag seen as long as the flag needs an argument
- * even if it is optional
- */
-static struct CxaFlag *LastSeen = NULL;
-
-/* 0. Stores the index where the flag with certain shortname can be found within 'flags' array
- * 1. Stores the longname length
- */
-static short QuickInf[26 * 2 + 10][2];
+static struct CxaContext Default = { .project = "unnamed" };
 
 static char *get_name_of_argtype (const CxaFlagMeta meta)
 {
@@ -42,108 +37,154 @@ static char *get_name_of_argtype (const CxaFlagMeta meta)
 	return NULL;
 }
 
-static void error_undefined_shortname (const char name, const char *group)
+/* Errors never leave the parser: the first one is described in the
+ * context and everything after it is skipped, the caller decides
+ * what to do about it (the non reentrant wrappers print and exit)
+ */
+static void fail (struct CxaContext *ctx, const int error, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+static void fail (struct CxaContext *ctx, const int error, const char *fmt, ...)
+{
+	if (ctx->error) { return; }
+
+	va_list ap;
+	va_start(ap, fmt);
+	vsnprintf(ctx->message, sizeof(ctx->message), fmt, ap);
+	va_end(ap);
+
+	ctx->error = error;
+}
+
+static void error_undefined_shortname (struct CxaContext *ctx, const char name, const char *group)
 {
-	const char *const fmt =
+	fail(ctx, CXA_ERR_SHORTNAME,
 	"cxa:%s:\x1b[31merror:\x1b[0m undefined flag provided\n"
 	"   '-%c' cannot be recognized as a program's argument\n"
-	"   found in '%s' group\n";
-	fprintf(stderr, fmt, Project, name, group);
-	exit(EXIT_FAILURE);
+	"   found in '%s' group\n", ctx->project, name, group);
 }
 
-static void error_multi_taker_in_group (const char first, const char second, const char *group)
+static void error_multi_taker_in_group (struct CxaContext *ctx, const char first, const char second, const char *group)
 {
-	const char *const fmt =
+	fail(ctx, CXA_ERR_MULTI_TAKER,
 	"cxa:%s:\x1b[31merror:\x1b[0m more than one flag takes argument in this group\n"
 	"   both '-%c' and '-%c' take argument (found in '%s' group)\n"
-	"   fix: ... -%c <arg> -%c <arg>\n";
-	fprintf(stderr, fmt, Project, first, second, group, first, second);
-	exit(EXIT_FAILURE);
+	"   fix: ... -%c <arg> -%c <arg>\n", ctx->project, first, second, group, first, second);
 }
 
-static void error_undefined_longname (const char *name, const size_t length)
+static void error_undefined_longname (struct CxaContext *ctx, const char *name, const size_t length)
 {
-	const char *const fmt =
+	fail(ctx, CXA_ERR_LONGNAME,
 	"cxa:%s:\x1b[31merror:\x1b[0m undefined flag provided\n"
-	"   '--%.*s' cannot be recognized as a program's argument\n";
-	fprintf(stderr, fmt, Project, (int) length, name);
-	exit(EXIT_FAILURE);
+	"   '--%.*s' cannot be recognized as a program's argument\n", ctx->project, (int) length, name);
+}
+
+static void error_response_file (struct CxaContext *ctx, const char *path, const char *why)
+{
+	fail(ctx, CXA_ERR_RESPONSE_FILE,
+	"cxa:%s:\x1b[31merror:\x1b[0m cannot use response file\n"
+	"   '%s': %s\n", ctx->project, path, why);
 }
 
-static void error_missing_argument (const char *longname, const char shortname, const CxaFlagMeta meta)
+static void error_missing_argument (struct CxaContext *ctx, const char *longname, const char shortname, const CxaFlagMeta meta)
 {
-	const char *const fmt =
+	fail(ctx, CXA_ERR_MISSING_ARG,
 	"cxa:%s:\x1b[31merror:\x1b[0m missing argument\n"
-	"   '--%s' (%c) is missing its argument of type <%s>\n";
-	fprintf(stderr, fmt, Project, longname, shortname, get_name_of_argtype(meta) + 1);
-	exit(EXIT_FAILURE);
+	"   '--%s' (%c) is missing its argument of type <%s>\n", ctx->project, longname, shortname, get_name_of_argtype(meta) + 1);
 }
 
-static void check_names (struct CxaFlag*);
+static void check_names (struct CxaContext*);
 static short get_quick_access_for (const char);
 
-static void handle_short_flag (struct CxaFlag*, const char*, const size_t);
-static void handle_long_flag (struct CxaFlag*, const char*);
+static short find_long_flag (const struct CxaContext*, const char*, const size_t);
+
+static void handle_short_flag (struct CxaContext*, const char*, const size_t);
+static void handle_long_flag (struct CxaContext*, const char*);
+
+static void check_flag_has_its_arg (struct CxaContext*);
+static void handle_freeword (struct CxaContext*, const char*, struct Cxa*);
 
-static void check_flag_has_its_arg (void);
-static void handle_freeword (const char*, struct Cxa*);
+static void handle_word (struct CxaContext*, char*, struct Cxa*, const unsigned short);
+static void expand_response_file (struct CxaContext*, const char*, struct Cxa*, const unsigned short);
+static char *next_word (char**, char*);
 
 static void store_positional_argument (struct Cxa*, const char*);
 
-struct Cxa *cxa_execute (const unsigned char argc, char **argv, struct CxaFlag *flags, const char *projectName)
+struct Cxa *cxa_execute (const int argc, char **argv, struct CxaFlag *flags, const char *projectName)
+{
+	return cxa_execute_hashed(argc, argv, flags, NULL, projectName);
+}
+
+struct Cxa *cxa_execute_hashed (const int argc, char **argv, struct CxaFlag *flags, const struct CxaHash *hash, const char *projectName)
+{
+	cxa_init_ctx(&Default, flags, hash, projectName);
+
+	struct Cxa *cxa = cxa_execute_ctx(&Default, argc, argv);
+	if (cxa == NULL)
+	{
+		fputs(Default.message, stderr);
+		exit(EXIT_FAILURE);
+	}
+	return cxa;
+}
+
+void cxa_init_ctx (struct CxaContext *ctx, struct CxaFlag *flags, const struct CxaHash *hash, const char *projectName)
+{
+	ctx->project  = projectName;
+	ctx->flags    = flags;
+	ctx->hash     = hash;
+	ctx->lastSeen = NULL;
+	check_names(ctx);
+}
+
+struct Cxa *cxa_execute_ctx (struct CxaContext *ctx, const int argc, char **argv)
 {
 	struct Cxa *cxa = (struct Cxa*) calloc(1, sizeof(struct Cxa));
-	cxa->positional = (char**)      calloc(CXA_POS_ARGS_GROWTH_FAC, sizeof(char*));
+	assert(cxa && "CANNOT ALLOC");
+
+	cxa->positional = (char**) calloc(CXA_POS_ARGS_INITIAL, sizeof(char*));
 	cxa->len        = 0;
-	cxa->cap        = CXA_POS_ARGS_GROWTH_FAC;
+	cxa->cap        = CXA_POS_ARGS_INITIAL;
 
-	assert(cxa && "CANNOT ALLOC");
 	assert(cxa->positional && "CANNOT ALLOC");
 
-	Project = (char*) projectName;
-	check_names(flags);
+	ctx->lastSeen   = NULL;
+	ctx->endOfArgs  = false;
+	ctx->error      = CXA_OK;
+	ctx->message[0] = 0;
 
-	bool endOfArgs = false;
-
-	for (unsigned char i = 1; i < argc; i++)
+	/* a context may be parsed over and over, nothing of the last
+	 * parse is left within the flags
+	 */
+	for (unsigned short i = 0; ctx->flags[i].longname; i++)
 	{
-		const char *this = argv[i];
-		const size_t len = strlen(this);
+		ctx->flags[i].meta &= (CxaFlagMeta) ~(CXA_FLAG_SEEN_MASK | CXA_FLAG_ARG_GIVEN_MASK);
+	}
 
-		if (endOfArgs)
-		{
-			handle_freeword(this, cxa);
-			continue;
-		}
-		else if (len == 2 && *this == '-' && this[1] == '-')
-		{
-			endOfArgs = true;
-			continue;
-		}
-		else if (len >  2 && *this == '-' && this[1] == '-')
-		{
-			check_flag_has_its_arg();
-			handle_long_flag(flags, this + 2);
-		}
-		else if (len >  1 && *this == '-')
-		{
-			check_flag_has_its_arg();
-			handle_short_flag(flags, this, len);
-		}
-		else
-		{
-			handle_freeword(this, cxa);
-		}
+	for (int i = 1; i < argc && !ctx->error; i++)
+	{
+		handle_word(ctx, argv[i], cxa, 0);
 	}
 
-	check_flag_has_its_arg();
+	check_flag_has_its_arg(ctx);
+	if (ctx->error)
+	{
+		cxa_clean(cxa);
+		return NULL;
+	}
 	return cxa;
 }
 
 void cxa_print_usage (const char *desc, const struct CxaFlag *flags)
 {
-	printf("\n\x1b[1mUsage\x1b[0m: %s - %s %s\n", Project, __DATE__, __TIME__);
+	const struct CxaContext ctx = { .project = Default.project, .flags = (struct CxaFlag*) flags };
+	cxa_print_usage_ctx(&ctx, desc);
+}
+
+void cxa_print_usage_ctx (const struct CxaContext *ctx, const char *desc)
+{
+	const struct CxaFlag *flags = ctx->flags;
+
+	printf("\n\x1b[1mUsage\x1b[0m: %s - %s %s\n", ctx->project, __DATE__, __TIME__);
 	printf("%s\n\n", desc);
 	printf("flags:\n");
 
@@ -183,15 +224,122 @@ void cxa_print_usage (const char *desc, const struct CxaFlag *flags)
 
 void cxa_clean (struct Cxa *cxa)
 {
+	for (unsigned long i = 0; i < cxa->nmappings; i++)
+	{
+		munmap(cxa->mappings[i].addr, cxa->mappings[i].len);
+	}
+	free(cxa->mappings);
 	free(cxa->positional);
 	free(cxa);
 }
 
-static void check_names (struct CxaFlag *flags)
+static void handle_word (struct CxaContext *ctx, char *this, struct Cxa *cxa, const unsigned short depth)
+{
+	const size_t len = strlen(this);
+
+	if (ctx->endOfArgs)
+	{
+		handle_freeword(ctx, this, cxa);
+	}
+	else if (len == 2 && *this == '-' && this[1] == '-')
+	{
+		ctx->endOfArgs = true;
+	}
+	else if (len >  2 && *this == '-' && this[1] == '-')
+	{
+		check_flag_has_its_arg(ctx);
+		handle_long_flag(ctx, this + 2);
+	}
+	else if (len >  1 && *this == '-')
+	{
+		check_flag_has_its_arg(ctx);
+		handle_short_flag(ctx, this, len);
+	}
+	else if (len >  1 && *this == CXA_RESPONSE_PREFIX && ctx->lastSeen == NULL)
+	{
+		expand_response_file(ctx, this + 1, cxa, depth + 1);
+	}
+	else
+	{
+		handle_freeword(ctx, this, cxa);
+	}
+}
+
+static void expand_response_file (struct CxaContext *ctx, const char *path, struct Cxa *cxa, const unsigned short depth)
+{
+	if (depth > CXA_RESPONSE_MAX_DEPTH)
+	{
+		error_response_file(ctx, path, "too deeply nested");
+		return;
+	}
+
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+	struct stat st;
+
+	if (fd == -1 || fstat(fd, &st) == -1)
+	{
+		error_response_file(ctx, path, strerror(errno));
+		if (fd != -1) { close(fd); }
+		return;
+	}
+	if (st.st_size == 0) { close(fd); return; }
+
+	/* words are cut in place: the file is mapped privately (pages only
+	 * get copied once a terminator lands on them) over an anonymous
+	 * region one byte longer, so even a word right at the end of the
+	 * file has a zero after it
+	 */
+	const size_t size = (size_t) st.st_size;
+	char *map = (char*) mmap(NULL, size + 1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (map == MAP_FAILED || mmap(map, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+	{
+		error_response_file(ctx, path, strerror(errno));
+		if (map != MAP_FAILED) { munmap(map, size + 1); }
+		close(fd);
+		return;
+	}
+	close(fd);
+
+	cxa->mappings = (struct CxaMapping*) realloc(cxa->mappings, (cxa->nmappings + 1) * sizeof(struct CxaMapping));
+	assert(cxa->mappings && "CANNOT ALLOC");
+	cxa->mappings[cxa->nmappings++] = (struct CxaMapping) { .addr = map, .len = size + 1 };
+
+	/* every word is handled as soon as it is found, as if it had
+	 * been given right where the '@file' was
+	 */
+	char *cursor = map, *word;
+	while (!ctx->error && (word = next_word(&cursor, map + size)))
+	{
+		handle_word(ctx, word, cxa, depth);
+	}
+}
+
+static char *next_word (char **cursor, char *end)
+{
+	char *at = *cursor;
+	while (at < end && isspace((unsigned char) *at)) { at++; }
+
+	if (at == end) { return NULL; }
+
+	char *word = at, close = 0;
+	if (*at == '"' || *at == '\'') { close = *at; word = ++at; }
+
+	while (at < end && (close ? *at != close : !isspace((unsigned char) *at))) { at++; }
+
+	/* 'end' is writable as well, see expand_response_file */
+	*at = 0;
+	*cursor = at + (at < end);
+	return word;
+}
+
+static void check_names (struct CxaContext *ctx)
 {
+	const struct CxaFlag *flags = ctx->flags;
+
 	for (unsigned short i = 0; i < 62; i++)
 	{
-		QuickInf[i][0] = -1;
+		ctx->quickInf[i][0] = -1;
 	}
 	for (unsigned short i = 0; flags[i].longname; i++)
 	{
@@ -199,12 +347,15 @@ static void check_names (struct CxaFlag *flags)
 		const short key      = get_quick_access_for(shortname);
 		
 		assert(key != -1 && "PROGRAMMER: INVALID SHORTNAME");
-		assert(QuickInf[key][0] == -1 && "PROGRAMMER: REPEATED SHORTNAMES");
+		assert(ctx->quickInf[key][0] == -1 && "PROGRAMMER: REPEATED SHORTNAMES");
 
 		const char *longname = flags[i].longname;
 
-		QuickInf[key][0] = i;
-		QuickInf[key][1] = (short) strlen(longname);
+		ctx->quickInf[key][0] = i;
+		ctx->quickInf[key][1] = (short) strlen(longname);
+
+		/* already done by the generator */
+		if (ctx->hash) { continue; }
 
 		for (unsigned short j = i + 1; flags[j].longname; j++)
 		{
@@ -222,36 +373,39 @@ static short get_quick_access_for (const char a)
 	return -1;
 }
 
-static void handle_short_flag (struct CxaFlag *flags, const char *given, const size_t len)
+static void handle_short_flag (struct CxaContext *ctx, const char *given, const size_t len)
 {
 	for (size_t i = 1; i < len; i++)
 	{
 		const char name = given[i];
 		const short key = get_quick_access_for(name);
 
-		if (key == -1 || QuickInf[key][0] == -1)
+		if (key == -1 || ctx->quickInf[key][0] == -1)
 		{
-			error_undefined_shortname(name, given);
+			error_undefined_shortname(ctx, name, given);
+			return;
 		}
 
-		struct CxaFlag *flag = &flags[QuickInf[key][0]];
+		struct CxaFlag *flag = &ctx->flags[ctx->quickInf[key][0]];
 		flag->meta |= CXA_FLAG_WAS_SEEN;
 
 		const bool takesArg = (flag->meta & CXA_FLAG_TAKER_MASK);
 
-		if (takesArg != CXA_FLAG_TAKER_NON && LastSeen)
+		if (takesArg != CXA_FLAG_TAKER_NON && ctx->lastSeen)
 		{
-			error_multi_taker_in_group(LastSeen->shortname, name, given);
+			error_multi_taker_in_group(ctx, ctx->lastSeen->shortname, name, given);
+			return;
 		}
 		if (takesArg != CXA_FLAG_TAKER_NON)
 		{
-			LastSeen = flag;
+			ctx->lastSeen = flag;
 		}
 	}
 }
 
-static void handle_long_flag (struct CxaFlag *flags, const char *given)
+static void handle_long_flag (struct CxaContext *ctx, const char *given)
 {
+	struct CxaFlag *flags = ctx->flags;
 	char *followedArgument = NULL;
 	size_t length = 0;
 
@@ -260,72 +414,105 @@ static void handle_long_flag (struct CxaFlag *flags, const char *given)
 		if (given[length] == '=') { followedArgument = ((char*) given) + length + 1; break; }
 	}
 
-	for (unsigned short i = 0; flags[i].longname; i++)
+	const short i = find_long_flag(ctx, given, length);
+	if (i == -1)
 	{
-		const size_t defFlagLen = (size_t) QuickInf[get_quick_access_for(flags[i].shortname)][1];
+		error_undefined_longname(ctx, given, length);
+		return;
+	}
 
-		if (length == defFlagLen && !strncmp(given, flags[i].longname, length))
-		{
-			flags[i].meta |= CXA_FLAG_WAS_SEEN;
-
-			if ((flags[i].meta & CXA_FLAG_TAKER_MASK) != CXA_FLAG_ARG_GIVEN_NON)
-			{
-				LastSeen = &flags[i];
-			}
-			if (LastSeen && followedArgument)
-			{
-				handle_freeword(followedArgument, NULL);
-			}
-			return;
-		}
+	flags[i].meta |= CXA_FLAG_WAS_SEEN;
+
+	if ((flags[i].meta & CXA_FLAG_TAKER_MASK) != CXA_FLAG_ARG_GIVEN_NON)
+	{
+		ctx->lastSeen = &flags[i];
+	}
+	if (ctx->lastSeen && followedArgument)
+	{
+		handle_freeword(ctx, followedArgument, NULL);
+	}
+}
+
+static inline unsigned int fnv1a (const char *str, const size_t len, const unsigned int seed)
+{
+	unsigned int hash = 2166136261u ^ seed;
+	for (size_t i = 0; i < len; i++)
+	{
+		hash ^= (unsigned char) str[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static short find_long_flag (const struct CxaContext *ctx, const char *given, const size_t length)
+{
+	const struct CxaFlag *flags = ctx->flags;
+	const struct CxaHash *hash  = ctx->hash;
+
+	if (hash)
+	{
+		/* the slot is the only candidate, one comparison confirms it */
+		const unsigned int disp = hash->disp[fnv1a(given, length, 0) % hash->nbuckets];
+		const short        i    = hash->slot[fnv1a(given, length, disp) % hash->size];
+
+		if (i == -1) { return -1; }
+
+		const size_t defFlagLen = (size_t) ctx->quickInf[get_quick_access_for(flags[i].shortname)][1];
+		return (length == defFlagLen && !strncmp(given, flags[i].longname, length)) ? i : -1;
+	}
+
+	for (unsigned short i = 0; flags[i].longname; i++)
+	{
+		const size_t defFlagLen = (size_t) ctx->quickInf[get_quick_access_for(flags[i].shortname)][1];
+		if (length == defFlagLen && !strncmp(given, flags[i].longname, length)) { return (short) i; }
 	}
-	error_undefined_longname(given, length);
+	return -1;
 }
 
-static void check_flag_has_its_arg (void)
+static void check_flag_has_its_arg (struct CxaContext *ctx)
 {
-	if (LastSeen && ((LastSeen->meta & CXA_FLAG_TAKER_MASK) == CXA_FLAG_TAKER_YES) && ((LastSeen->meta & CXA_FLAG_ARG_GIVEN_MASK) == CXA_FLAG_ARG_GIVEN_NON))
+	if (ctx->lastSeen && ((ctx->lastSeen->meta & CXA_FLAG_TAKER_MASK) == CXA_FLAG_TAKER_YES) && ((ctx->lastSeen->meta & CXA_FLAG_ARG_GIVEN_MASK) == CXA_FLAG_ARG_GIVEN_NON))
 	{
-		error_missing_argument(LastSeen->longname, LastSeen->shortname, LastSeen->meta);
+		error_missing_argument(ctx, ctx->lastSeen->longname, ctx->lastSeen->shortname, ctx->lastSeen->meta);
 	}
-	LastSeen = NULL;
+	ctx->lastSeen = NULL;
 }
 
-static void handle_freeword (const char *word, struct Cxa *cxa)
+static void handle_freeword (struct CxaContext *ctx, const char *word, struct Cxa *cxa)
 {
-	if (LastSeen == NULL)
+	if (ctx->lastSeen == NULL)
 	{
 		store_positional_argument(cxa, word);
 		return;
 	}
 
-	assert(LastSeen->destination != NULL && "NO DESTINATION ASSIGNED FOR A FLAG");
+	assert(ctx->lastSeen->destination != NULL && "NO DESTINATION ASSIGNED FOR A FLAG");
 	errno = 0;
 
-	switch (LastSeen->meta & CXA_ARG_TYPE_MASK)
+	switch (ctx->lastSeen->meta & CXA_ARG_TYPE_MASK)
 	{
-		case CXA_FLAG_ARG_TYPE_STR: *(char**)  LastSeen->destination = (char*)  word;                  break;
-		case CXA_FLAG_ARG_TYPE_CHR: *(char*)   LastSeen->destination = (char)   *word;                 break;
-		case CXA_FLAG_ARG_TYPE_SHT: *(short*)  LastSeen->destination = (short)  strtol(word, NULL, 0); break;
-		case CXA_FLAG_ARG_TYPE_INT: *(int*)    LastSeen->destination = (int)    strtol(word, NULL, 0); break;
-		case CXA_FLAG_ARG_TYPE_LNG: *(long*)   LastSeen->destination = (long)   strtol(word, NULL, 0); break;
-		case CXA_FLAG_ARG_TYPE_DBL: *(double*) LastSeen->destination = (double) strtod(word, NULL);    break;
+		case CXA_FLAG_ARG_TYPE_STR: *(char**)  ctx->lastSeen->destination = (char*)  word;                  break;
+		case CXA_FLAG_ARG_TYPE_CHR: *(char*)   ctx->lastSeen->destination = (char)   *word;                 break;
+		case CXA_FLAG_ARG_TYPE_SHT: *(short*)  ctx->lastSeen->destination = (short)  strtol(word, NULL, 0); break;
+		case CXA_FLAG_ARG_TYPE_INT: *(int*)    ctx->lastSeen->destination = (int)    strtol(word, NULL, 0); break;
+		case CXA_FLAG_ARG_TYPE_LNG: *(long*)   ctx->lastSeen->destination = (long)   strtol(word, NULL, 0); break;
+		case CXA_FLAG_ARG_TYPE_DBL: *(double*) ctx->lastSeen->destination = (double) strtod(word, NULL);    break;
 	}
 
 	if (errno != 0)
 	{
-		error_missing_argument(LastSeen->longname, LastSeen->shortname, LastSeen->meta);
+		error_missing_argument(ctx, ctx->lastSeen->longname, ctx->lastSeen->shortname, ctx->lastSeen->meta);
 	}
 
-	LastSeen->meta |= CXA_FLAG_ARG_GIVEN_YES;
-	LastSeen = NULL;
+	ctx->lastSeen->meta |= CXA_FLAG_ARG_GIVEN_YES;
+	ctx->lastSeen = NULL;
 }
 
 static void store_positional_argument (struct Cxa *cxa, const char *pos)
 {
 	if (cxa->len == cxa->cap)
 	{
-		cxa->cap += CXA_POS_ARGS_GROWTH_FAC;
+		cxa->cap *= 2;
 		cxa->positional = (char**) realloc(cxa->positional, cxa->cap * sizeof(char*));
 		assert(cxa->positional && "CANNOT ALLOC");
 	}
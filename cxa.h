@@ -55,9 +55,28 @@ extern "C" {
  */
 #define CXA_SET_END             {NULL}
 
-/* Factor in which the positional arguments grows
+/* Room for positional arguments at first, doubled whenever
+ * it runs out
  */
-#define CXA_POS_ARGS_GROWTH_FAC 32
+#define CXA_POS_ARGS_INITIAL    32
+
+/* '@file' arguments are replaced by the words within 'file' (split
+ * on whitespace, a word may be quoted with '' or ""), response files
+ * can refer to other ones up to this depth
+ */
+#define CXA_RESPONSE_PREFIX     '@'
+#define CXA_RESPONSE_MAX_DEPTH  8
+
+/* What went wrong with a parse (CxaContext.error), the context's
+ * message tells the details
+ */
+#define CXA_OK                  0
+#define CXA_ERR_SHORTNAME       1
+#define CXA_ERR_MULTI_TAKER     2
+#define CXA_ERR_LONGNAME        3
+#define CXA_ERR_RESPONSE_FILE   4
+#define CXA_ERR_MISSING_ARG     5
+#define CXA_MESSAGE_SIZE        512
 
 typedef unsigned char CxaFlagMeta;
 
@@ -70,14 +89,68 @@ struct CxaFlag
 	char            shortname;
 };
 
-struct Cxa
+/* Response files stay mapped as long as the results live since
+ * words point straight into them
+ */
+struct CxaMapping
 {
-	char          **positional;
+	void          *addr;
 	unsigned long len;
-	unsigned long cap;
 };
 
-struct Cxa *cxa_execute (const unsigned char, char**, struct CxaFlag*, const char*);
+struct Cxa
+{
+	char              **positional;
+	unsigned long     len;
+	unsigned long     cap;
+	struct CxaMapping *mappings;
+	unsigned long     nmappings;
+};
+
+/* Perfect hash (hash and displace, FNV-1a) over the longnames of a
+ * flag array, generated at build time by tools/mkflagset.py: long
+ * flags are found in O(1) and repeated names never reach runtime
+ */
+struct CxaHash
+{
+	const unsigned int *disp;
+	const short        *slot;
+	unsigned short     nbuckets, size;
+};
+
+/* Everything a parse needs besides the arguments themselves, there
+ * is no state shared between contexts so as long as every thread
+ * uses its own context (and its own flags array, since that is where
+ * results are left) parsing is reentrant and needs no locking
+ */
+struct CxaContext
+{
+	const char           *project;
+	struct CxaFlag       *flags;
+	const struct CxaHash *hash;
+	/* last flag seen as long as it takes an argument (even optional) */
+	struct CxaFlag       *lastSeen;
+	/* '--' was given, whatever follows is positional */
+	int                  endOfArgs;
+	/* 0. index of the flag with certain shortname within 'flags'
+	 * 1. its longname length
+	 */
+	short                quickInf[26 * 2 + 10][2];
+	/* first error of the last parse (CXA_OK if none) */
+	int                  error;
+	char                 message[CXA_MESSAGE_SIZE];
+};
+
+void cxa_init_ctx (struct CxaContext*, struct CxaFlag*, const struct CxaHash*, const char*);
+/* NULL when the arguments are wrong, see the context's error */
+struct Cxa *cxa_execute_ctx (struct CxaContext*, const int, char**);
+void cxa_print_usage_ctx (const struct CxaContext*, const char*);
+
+/* Same as above over a context of their own, not reentrant, a
+ * wrong argument prints the error and exits
+ */
+struct Cxa *cxa_execute (const int, char**, struct CxaFlag*, const char*);
+struct Cxa *cxa_execute_hashed (const int, char**, struct CxaFlag*, const struct CxaHash*, const char*);
 void cxa_print_usage (const char*, const struct CxaFlag*);
 void cxa_clean (struct Cxa*);
 
@@ -0,0 +1,642 @@
+#define _GNU_SOURCE
+#include "daemon.h"
+#include "common.h"
+#include "back.h"
+#include "tick.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+
+#define NO_HEAP        UINT32_MAX
+#define MAX_EVENTS     64
+
+/* Finished timers only fill the journal's batch, it is synced (and
+ * the index brought up to date) at most this long after the first
+ * one of them, never while handling a request or a deadline
+ */
+#define SYNC_AFTER     NS_PER_SEC
+
+enum tstate
+{
+	tstate_free = 0,
+	tstate_wkg  = 1,
+	tstate_psd  = 2,
+};
+
+static const char *const TStates[] =
+{
+	"free",
+	"working",
+	"paused",
+};
+
+/* Idle (paused) timers cost their slot and nothing else, only
+ * running ones sit in the heap and only the earliest deadline
+ * is armed in the kernel
+ */
+struct timer
+{
+	char           task[BACK_TASK_SIZE];
+	/* ns worked before 'resumed', which is 0 while paused */
+	int64_t        banked, resumed;
+	int64_t        deadline;
+	uint32_t       total, pauses, heap;
+	unsigned short watchers;
+	unsigned char  state;
+	/* the journal session this timer's record belongs to */
+	struct record  session;
+};
+
+struct client
+{
+	char         in[DAEMON_MAX_LINE];
+	size_t       len;
+	unsigned int attached;
+	int          fd;
+	/* 'dead' ones are closed already and freed by bury_clients */
+	bool_t       eof, dead;
+};
+
+struct daemon
+{
+	struct timer  *timers;
+	uint32_t      *heap;
+	struct client **clients;
+	uint32_t      ntimers, nheap, nclients, cclients;
+	int           epfd, tfd, sfd, lfd;
+	bool_t        quit;
+	/* open for as long as the daemon runs, 'sync_at' is 0 while
+	 * nothing is waiting in its batch
+	 */
+	struct journal journal;
+	int64_t        sync_at;
+};
+
+static void drop_client (struct daemon*, struct client*);
+static void reap_clients (struct daemon*);
+static void bury_clients (struct daemon*);
+
+static void *xrealloc (void *ptr, const size_t size)
+{
+	void *new = realloc(ptr, size);
+	if (new == NULL)
+	{
+		fprintf(stderr, "%s: error: out of memory\n", PROGRAM_NAME);
+		exit(EXIT_FAILURE);
+	}
+	return new;
+}
+
+static void socket_path (struct sockaddr_un *addr)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+
+	const char *env = getenv(DAEMON_SOCKET_ENV);
+	const char *run = getenv("XDG_RUNTIME_DIR");
+
+	if (env && *env)    { snprintf(addr->sun_path, sizeof(addr->sun_path), "%s", env); }
+	else if (run && *run) { snprintf(addr->sun_path, sizeof(addr->sun_path), "%s/%s.sock", run, PROGRAM_NAME); }
+	else                { snprintf(addr->sun_path, sizeof(addr->sun_path), "/tmp/%s-%u.sock", PROGRAM_NAME, (unsigned) getuid()); }
+}
+
+static inline int64_t worked_ns (const struct timer *t, const int64_t now)
+{
+	return t->banked + (t->resumed ? now - t->resumed : 0);
+}
+
+/* Min-heap of running timers ordered by deadline */
+static void heap_swap (struct daemon *d, const uint32_t a, const uint32_t b)
+{
+	const uint32_t tmp = d->heap[a];
+	d->heap[a] = d->heap[b];
+	d->heap[b] = tmp;
+
+	d->timers[d->heap[a]].heap = a;
+	d->timers[d->heap[b]].heap = b;
+}
+
+static void heap_fix (struct daemon *d, uint32_t i)
+{
+	while (i && d->timers[d->heap[i]].deadline < d->timers[d->heap[(i - 1) / 2]].deadline)
+	{
+		heap_swap(d, i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+
+	for (;;)
+	{
+		const uint32_t l = 2 * i + 1, r = l + 1;
+		uint32_t min = i;
+
+		if (l < d->nheap && d->timers[d->heap[l]].deadline < d->timers[d->heap[min]].deadline) min = l;
+		if (r < d->nheap && d->timers[d->heap[r]].deadline < d->timers[d->heap[min]].deadline) min = r;
+		if (min == i) return;
+
+		heap_swap(d, i, min);
+		i = min;
+	}
+}
+
+static void heap_remove (struct daemon *d, const uint32_t id)
+{
+	const uint32_t at = d->timers[id].heap;
+	if (at == NO_HEAP) return;
+
+	heap_swap(d, at, --d->nheap);
+	d->timers[id].heap = NO_HEAP;
+
+	if (at < d->nheap) heap_fix(d, at);
+}
+
+static void schedule (struct daemon *d, const uint32_t id, const int64_t now)
+{
+	struct timer *t = &d->timers[id];
+	if (t->state != tstate_wkg) { heap_remove(d, id); return; }
+
+	/* the only moment that matters is the end, unless somebody is
+	 * watching, then the next whole second is needed too
+	 */
+	const int64_t worked = worked_ns(t, now);
+	t->deadline = now + ((int64_t) t->total * NS_PER_SEC - worked);
+
+	if (t->watchers)
+	{
+		const int64_t next = now + (NS_PER_SEC - worked % NS_PER_SEC);
+		if (next < t->deadline) t->deadline = next;
+	}
+
+	if (t->heap == NO_HEAP)
+	{
+		d->heap[d->nheap] = id;
+		t->heap = d->nheap++;
+	}
+
+	heap_fix(d, t->heap);
+}
+
+static void arm (struct daemon *d)
+{
+	struct itimerspec its = { 0 };
+	if (d->nheap)
+	{
+		int64_t when = d->timers[d->heap[0]].deadline;
+		if (when <= 0) when = 1;
+
+		its.it_value.tv_sec  = when / NS_PER_SEC;
+		its.it_value.tv_nsec = when % NS_PER_SEC;
+	}
+	timerfd_settime(d->tfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static void reply (struct client *c, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void reply (struct client *c, const char *fmt, ...)
+{
+	char buf[DAEMON_MAX_LINE + 64];
+	va_list ap;
+
+	va_start(ap, fmt);
+	const int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+	va_end(ap);
+
+	/* a client which cannot keep up is not worth blocking for, it
+	 * will be dropped as soon as its socket reports the error
+	 */
+	if (n > 0) send(c->fd, buf, (size_t) n < sizeof(buf) ? (size_t) n : sizeof(buf) - 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+
+static void reply_status (struct daemon *d, struct client *c, const uint32_t id, const int64_t now)
+{
+	const struct timer *t = &d->timers[id];
+	reply(c, "%u %s %lu %u %s\n", id + 1, TStates[t->state], (unsigned long) (worked_ns(t, now) / NS_PER_SEC), t->total, t->task);
+}
+
+static void notify (struct daemon *d, const uint32_t id, const int64_t now)
+{
+	if (d->timers[id].watchers == 0) return;
+
+	for (uint32_t i = 0; i < d->nclients; i++)
+		if (d->clients[i]->attached == id + 1) reply_status(d, d->clients[i], id, now);
+}
+
+static void finish (struct daemon *d, const uint32_t id, const enum reason reason, const int64_t now)
+{
+	struct timer *t = &d->timers[id];
+	const unsigned int worked = (unsigned int) (worked_ns(t, now) / NS_PER_SEC);
+
+	backend_append(&d->journal, &t->session, reason, worked, t->pauses, 0);
+	if (d->sync_at == 0) d->sync_at = now + SYNC_AFTER;
+
+	for (uint32_t i = 0; i < d->nclients; i++)
+	{
+		struct client *c = d->clients[i];
+		if (c->attached != id + 1) continue;
+
+		reply(c, "%u done %u %u %s\n", id + 1, worked, t->total, t->task);
+		c->attached = 0;
+	}
+
+	heap_remove(d, id);
+	memset(t, 0, sizeof(*t));
+	t->heap = NO_HEAP;
+}
+
+static struct timer *timer_by_id (struct daemon *d, const char *arg, uint32_t *id)
+{
+	const unsigned long n = strtoul(arg, NULL, 10);
+	if (n == 0 || n > d->ntimers || d->timers[n - 1].state == tstate_free) return NULL;
+
+	*id = (uint32_t) n - 1;
+	return &d->timers[*id];
+}
+
+static uint32_t timer_new (struct daemon *d)
+{
+	for (uint32_t i = 0; i < d->ntimers; i++)
+		if (d->timers[i].state == tstate_free) return i;
+
+	const uint32_t cap = d->ntimers ? d->ntimers << 1 : 16;
+
+	d->timers = (struct timer*) xrealloc(d->timers, cap * sizeof(struct timer));
+	d->heap   = (uint32_t*)     xrealloc(d->heap,   cap * sizeof(uint32_t));
+
+	memset(d->timers + d->ntimers, 0, (cap - d->ntimers) * sizeof(struct timer));
+	for (uint32_t i = d->ntimers; i < cap; i++) d->timers[i].heap = NO_HEAP;
+
+	const uint32_t id = d->ntimers;
+	d->ntimers = cap;
+	return id;
+}
+
+static void handle_line (struct daemon *d, struct client *c, char *line)
+{
+	const int64_t now = tick_now();
+	char *arg = strchr(line, ' ');
+
+	if (arg) *arg++ = 0;
+	else arg = line + strlen(line);
+
+	uint32_t id;
+	struct timer *t;
+
+	if (!strcmp(line, "start"))
+	{
+		char *task;
+		const long mins = strtol(arg, &task, 10);
+
+		while (*task == ' ') task++;
+		if (mins <= 0 || *task == 0) { reply(c, "err usage: start <mins> <task>\n"); return; }
+
+		id = timer_new(d);
+		t  = &d->timers[id];
+
+		strncpy(t->task, task, BACK_TASK_SIZE - 1);
+		backend_session(&t->session, task, "daemon", (unsigned int) mins * 60);
+		t->total   = (uint32_t) mins * 60;
+		t->state   = tstate_wkg;
+		t->resumed = now;
+
+		schedule(d, id, now);
+		reply(c, "ok %u\n", id + 1);
+	}
+	else if (!strcmp(line, "pause") || !strcmp(line, "resume"))
+	{
+		if ((t = timer_by_id(d, arg, &id)) == NULL) { reply(c, "err no such timer\n"); return; }
+
+		if (*line == 'p' && t->state == tstate_wkg)
+		{
+			t->banked  = worked_ns(t, now);
+			t->resumed = 0;
+			t->state   = tstate_psd;
+			t->pauses++;
+		}
+		else if (*line == 'r' && t->state == tstate_psd)
+		{
+			t->resumed = now;
+			t->state   = tstate_wkg;
+		}
+
+		schedule(d, id, now);
+		notify(d, id, now);
+		reply(c, "ok\n");
+	}
+	else if (!strcmp(line, "stop"))
+	{
+		if ((t = timer_by_id(d, arg, &id)) == NULL) { reply(c, "err no such timer\n"); return; }
+
+		reply(c, "ok\n");
+		finish(d, id, reason_quit, now);
+	}
+	else if (!strcmp(line, "list"))
+	{
+		for (id = 0; id < d->ntimers; id++)
+			if (d->timers[id].state != tstate_free) reply_status(d, c, id, now);
+		reply(c, ".\n");
+	}
+	else if (!strcmp(line, "attach"))
+	{
+		if ((t = timer_by_id(d, arg, &id)) == NULL) { reply(c, "err no such timer\n"); return; }
+		if (c->attached) d->timers[c->attached - 1].watchers--;
+
+		c->attached = id + 1;
+		t->watchers++;
+
+		reply(c, "ok\n");
+		reply_status(d, c, id, now);
+		schedule(d, id, now);
+	}
+	else if (!strcmp(line, "detach"))
+	{
+		if (c->attached)
+		{
+			d->timers[c->attached - 1].watchers--;
+			schedule(d, c->attached - 1, now);
+		}
+
+		c->attached = 0;
+		reply(c, "ok\n");
+	}
+	else
+	{
+		reply(c, "err unknown command '%s'\n", line);
+	}
+}
+
+static void drop_client (struct daemon *d, struct client *c)
+{
+	if (c->dead) return;
+
+	if (c->attached)
+	{
+		d->timers[c->attached - 1].watchers--;
+		schedule(d, c->attached - 1, tick_now());
+	}
+
+	/* closing takes it out of the epoll set, but an event of the
+	 * batch being handled may still point at it, so the memory is
+	 * only given back once the whole batch is done (bury_clients)
+	 */
+	close(c->fd);
+	c->attached = 0;
+	c->dead     = TRUE;
+}
+
+static void accept_clients (struct daemon *d)
+{
+	int fd;
+	while ((fd = accept4(d->lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) != -1)
+	{
+		struct client *c = (struct client*) calloc(1, sizeof(struct client));
+		if (c == NULL) { close(fd); continue; }
+
+		c->fd = fd;
+
+		if (d->nclients == d->cclients)
+		{
+			d->cclients = d->cclients ? d->cclients << 1 : 16;
+			d->clients  = (struct client**) xrealloc(d->clients, d->cclients * sizeof(struct client*));
+		}
+		d->clients[d->nclients++] = c;
+
+		struct epoll_event ev = { .events = EPOLLIN | EPOLLRDHUP, .data.ptr = c };
+		epoll_ctl(d->epfd, EPOLL_CTL_ADD, fd, &ev);
+	}
+}
+
+static void serve_client (struct daemon *d, struct client *c, const uint32_t events)
+{
+	if (c->dead) return;
+
+	for (;;)
+	{
+		const ssize_t n = read(c->fd, c->in + c->len, sizeof(c->in) - 1 - c->len);
+		if (n == 0) { c->eof = TRUE; break; }
+		if (n == -1) { if (errno != EAGAIN && errno != EINTR) c->eof = TRUE; break; }
+
+		c->len += (size_t) n;
+
+		char *line = c->in, *nl;
+		while ((nl = memchr(line, '\n', c->len - (line - c->in))))
+		{
+			*nl = 0;
+			handle_line(d, c, line);
+			line = nl + 1;
+		}
+
+		c->len -= (size_t) (line - c->in);
+		memmove(c->in, line, c->len);
+
+		/* a line longer than the buffer is just garbage */
+		if (c->len == sizeof(c->in) - 1) c->len = 0;
+	}
+
+	/* nothing else to read, from now on only a hang up matters */
+	if (c->eof)
+	{
+		struct epoll_event ev = { .events = 0, .data.ptr = c };
+		epoll_ctl(d->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+	}
+
+	if (events & (EPOLLHUP | EPOLLERR)) drop_client(d, c);
+
+	reap_clients(d);
+}
+
+static void reap_clients (struct daemon *d)
+{
+	/* a client done talking stays around only while attached */
+	for (uint32_t i = 0; i < d->nclients; i++)
+		if (d->clients[i]->eof && !d->clients[i]->attached) drop_client(d, d->clients[i]);
+}
+
+static void bury_clients (struct daemon *d)
+{
+	for (uint32_t i = 0; i < d->nclients; )
+	{
+		if (!d->clients[i]->dead) { i++; continue; }
+
+		free(d->clients[i]);
+		d->clients[i] = d->clients[--d->nclients];
+	}
+}
+
+static void expire (struct daemon *d)
+{
+	uint64_t expired;
+	if (read(d->tfd, &expired, sizeof(expired)) != sizeof(expired)) return;
+
+	const int64_t now = tick_now();
+
+	while (d->nheap && d->timers[d->heap[0]].deadline <= now)
+	{
+		const uint32_t id = d->heap[0];
+		const struct timer *t = &d->timers[id];
+
+		if (worked_ns(t, now) >= (int64_t) t->total * NS_PER_SEC)
+		{
+			finish(d, id, reason_done, now);
+			continue;
+		}
+
+		notify(d, id, now);
+		schedule(d, id, now);
+	}
+
+	reap_clients(d);
+}
+
+static bool_t setup (struct daemon *d)
+{
+	struct sockaddr_un addr;
+	socket_path(&addr);
+
+	d->lfd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (d->lfd == -1) return FALSE;
+
+	/* a socket nobody answers on is left over by a dead daemon */
+	if (bind(d->lfd, (struct sockaddr*) &addr, sizeof(addr)) == -1)
+	{
+		const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		const bool_t alive = connect(probe, (struct sockaddr*) &addr, sizeof(addr)) == 0;
+		close(probe);
+
+		if (alive || unlink(addr.sun_path) == -1 || bind(d->lfd, (struct sockaddr*) &addr, sizeof(addr)) == -1) return FALSE;
+	}
+
+	if (listen(d->lfd, SOMAXCONN) == -1) return FALSE;
+
+	sigset_t set;
+	sigemptyset(&set);
+	sigaddset(&set, SIGINT);
+	sigaddset(&set, SIGTERM);
+	sigaddset(&set, SIGHUP);
+	sigprocmask(SIG_BLOCK, &set, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	d->sfd  = signalfd(-1, &set, SFD_NONBLOCK | SFD_CLOEXEC);
+	d->tfd  = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	d->epfd = epoll_create1(EPOLL_CLOEXEC);
+
+	if (d->sfd == -1 || d->tfd == -1 || d->epfd == -1) return FALSE;
+
+	int *const fds[] = { &d->lfd, &d->sfd, &d->tfd };
+	for (unsigned short i = 0; i < sizeof(fds) / sizeof(fds[0]); i++)
+	{
+		struct epoll_event ev = { .events = EPOLLIN, .data.ptr = fds[i] };
+		if (epoll_ctl(d->epfd, EPOLL_CTL_ADD, *fds[i], &ev) == -1) return FALSE;
+	}
+
+	return TRUE;
+}
+
+void daemon_run (void)
+{
+	struct daemon d = { .epfd = -1, .tfd = -1, .sfd = -1, .lfd = -1 };
+
+	if (!setup(&d))
+	{
+		fprintf(stderr, "%s: error: cannot start the daemon (is another one running?)\n", PROGRAM_NAME);
+		exit(EXIT_FAILURE);
+	}
+	if (!backend_attach(&d.journal))
+	{
+		fprintf(stderr, "%s: warning: cannot open journal '%s', progress won't be saved\n", PROGRAM_NAME, backend_journal_path());
+	}
+
+	struct epoll_event evs[MAX_EVENTS];
+
+	while (!d.quit)
+	{
+		arm(&d);
+
+		int timeout = -1;
+		if (d.sync_at)
+		{
+			const int64_t wait = d.sync_at - tick_now();
+			timeout = wait > 0 ? (int) ((wait + NS_PER_MS - 1) / NS_PER_MS) : 0;
+		}
+
+		const int n = epoll_wait(d.epfd, evs, MAX_EVENTS, timeout);
+		for (int i = 0; i < n; i++)
+		{
+			void *who = evs[i].data.ptr;
+
+			if      (who == &d.lfd) { accept_clients(&d); }
+			else if (who == &d.tfd) { expire(&d); }
+			else if (who == &d.sfd) { d.quit = TRUE; }
+			else                    { serve_client(&d, (struct client*) who, evs[i].events); }
+		}
+
+		bury_clients(&d);
+
+		if (d.sync_at && tick_now() >= d.sync_at)
+		{
+			backend_sync(&d.journal);
+			d.sync_at = 0;
+		}
+	}
+
+	/* whatever is still around gets saved, all of it at once */
+	const int64_t now = tick_now();
+	for (uint32_t id = 0; id < d.ntimers; id++)
+		if (d.timers[id].state != tstate_free) finish(&d, id, reason_hangup, now);
+
+	backend_close(&d.journal);
+
+	for (uint32_t i = 0; i < d.nclients; i++) drop_client(&d, d.clients[i]);
+	bury_clients(&d);
+
+	struct sockaddr_un addr;
+	socket_path(&addr);
+	unlink(addr.sun_path);
+
+	free(d.timers);
+	free(d.heap);
+	free(d.clients);
+}
+
+int daemon_command (const char *command)
+{
+	struct sockaddr_un addr;
+	socket_path(&addr);
+
+	const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd == -1 || connect(fd, (struct sockaddr*) &addr, sizeof(addr)) == -1)
+	{
+		fprintf(stderr, "%s: error: cannot reach the daemon at '%s'\n", PROGRAM_NAME, addr.sun_path);
+		return EXIT_FAILURE;
+	}
+
+	/* the daemon hangs up once it's done answering, unless the
+	 * command attached to a timer, then updates keep coming
+	 */
+	char buf[DAEMON_MAX_LINE + 64];
+	const int len = snprintf(buf, sizeof(buf), "%s\n", command);
+
+	if (write(fd, buf, (size_t) len) != len) { close(fd); return EXIT_FAILURE; }
+	shutdown(fd, SHUT_WR);
+
+	ssize_t n;
+	int status = EXIT_SUCCESS;
+
+	while ((n = read(fd, buf, sizeof(buf))) > 0)
+	{
+		if (!strncmp(buf, "err", 3)) status = EXIT_FAILURE;
+		fwrite(buf, 1, (size_t) n, stdout);
+		fflush(stdout);
+	}
+
+	close(fd);
+	return status;
+}
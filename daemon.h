@@ -0,0 +1,23 @@
+#ifndef FT_DAEMON_H
+#define FT_DAEMON_H
+
+/* Line based protocol spoken over the daemon's socket, every
+ * request gets 'ok ...' or 'err ...' back
+ *
+ *  start <mins> <task>   new running timer, replies its id
+ *  pause <id>            stops counting
+ *  resume <id>           counts again
+ *  stop <id>             saves progress and drops the timer
+ *  list                  one status line per timer then '.'
+ *  attach <id>           status line at every visible change
+ *  detach                stops the updates
+ *
+ * status line: <id> <state> <worked secs> <total secs> <task>
+ */
+#define DAEMON_SOCKET_ENV      "FT_SOCKET"
+#define DAEMON_MAX_LINE        256
+
+void daemon_run (void);
+int daemon_command (const char*);
+
+#endif
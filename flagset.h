@@ -0,0 +1,28 @@
+#ifndef FT_FLAGSET_H
+#define FT_FLAGSET_H
+
+/* Perfect hash over the long names of the flags defined in main.c
+ * generated by tools/mkflagset.py, do not edit by hand
+ */
+
+#define FLAGS_COUNT 12
+
+/*  0: task */
+/*  1: font */
+/*  2: time */
+/*  3: list */
+/*  4: prev */
+/*  5: stats */
+/*  6: daemon */
+/*  7: ctl */
+/*  8: stats-out */
+/*  9: plan */
+/* 10: resume */
+/* 11: status */
+
+static const unsigned int FlagDisp[6] = { 2, 2, 1, 3, 2, 1 };
+static const short        FlagSlot[32] = { 9, 0, 4, -1, -1, 2, -1, -1, 6, -1, -1, -1, 7, -1, 1, 5, -1, 11, 3, -1, -1, -1, -1, 10, -1, -1, -1, -1, -1, -1, -1, 8 };
+
+static const struct CxaHash FlagHash = { FlagDisp, FlagSlot, 6, 32 };
+
+#endif
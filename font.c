@@ -0,0 +1,183 @@
+#include "font.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "fontset.h"
+
+const unsigned short NoFonts = NO_FONTS;
+
+/* FIGlet fonts define characters from ' ' onwards in ASCII order,
+ * '0'..'9' and ':' happen to be consecutive so they are the only
+ * glyphs that need to be decoded
+ */
+#define FLF_SIGNATURE     "flf2a"
+#define FLF_FIRST_CHAR    ' '
+#define FLF_FIRST_NEEDED  '0'
+
+/* 32-bit FNV-1a, the seed is mixed into the offset basis so that
+ * the very same function serves both levels of the perfect hash
+ */
+static inline uint32_t fnv1a (const char *str, const uint32_t seed)
+{
+	uint32_t hash = 2166136261u ^ seed;
+	for (; *str; str++)
+	{
+		hash ^= (unsigned char) *str;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+const struct font_t *font_lookup (const char *name)
+{
+	/* hash and displace: the first hash picks a bucket whose seed
+	 * leads the second hash to a collision-free slot, one strcmp
+	 * confirms the name was actually defined
+	 */
+	const uint32_t disp = FontDisp[fnv1a(name, 0) % FONT_HASH_BUCKETS];
+	const short    slot = FontSlot[fnv1a(name, disp) % FONT_HASH_SIZE];
+
+	if (slot == -1 || strcmp(FontTable[slot].name, name)) return NULL;
+	return FontTable[slot].font;
+}
+
+const struct font_entry *font_fitting (const unsigned short height, const unsigned short width)
+{
+	for (unsigned short i = 0; i < NO_FONTS; i++)
+	{
+		const struct font_footprint *fp = &FontFootprint[i];
+		if (fp->height <= height && fp->width <= width) return &FontTable[fp->index];
+	}
+	return NULL;
+}
+
+const struct font_entry *font_smallest (void)
+{
+	return &FontTable[FontFootprint[NO_FONTS - 1].index];
+}
+
+static const char *next_line (const char *line, const char *end)
+{
+	const char *nl = (const char*) memchr(line, '\n', end - line);
+	return nl ? nl + 1 : end;
+}
+
+/* Rows are measured, never terminated in place: the mapping is read
+ * only, and a file without a trailing newline whose size is a multiple
+ * of the page size ends right at the last byte that may be touched
+ */
+static unsigned short decode_row (const char *line, const char *end)
+{
+	const char *eol = (const char*) memchr(line, '\n', end - line);
+	if (eol == NULL) eol = end;
+	if (eol > line && eol[-1] == '\r') eol--;
+
+	/* every row finishes with an endmark (doubled for the last row
+	 * of a character) which is not part of the glyph
+	 */
+	if (eol > line)
+	{
+		const char endmark = eol[-1];
+		while (eol > line && eol[-1] == endmark) eol--;
+	}
+
+	return (unsigned short) (eol - line);
+}
+
+const struct font_t *font_load_flf (const char *path)
+{
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size < (off_t) sizeof(FLF_SIGNATURE))
+	{
+		close(fd);
+		return NULL;
+	}
+
+	/* the file is never read as a whole, only the pages holding the
+	 * header and the 11 glyphs get faulted in
+	 */
+	const char *map = (const char*) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED) return NULL;
+
+	const char *end = map + st.st_size;
+	const char *line = next_line(map, end);
+
+	struct font_t *font = (struct font_t*) calloc(1, sizeof(struct font_t));
+	const char *rows[FONT_CHARSET_SIZE][WIDEST_FONT];
+	char *atlas = NULL, header[128];
+
+	char hardblank;
+	int height, comments;
+
+	const size_t hlen = (size_t) (line - map) < sizeof(header) ? (size_t) (line - map) : sizeof(header) - 1;
+	memcpy(header, map, hlen);
+	header[hlen] = 0;
+
+	if (font == NULL || strncmp(header, FLF_SIGNATURE, sizeof(FLF_SIGNATURE) - 1) ||
+	    sscanf(header + sizeof(FLF_SIGNATURE) - 1, "%c %d %*d %*d %*d %d", &hardblank, &height, &comments) != 3 ||
+	    height < 1 || height > WIDEST_FONT || comments < 0)
+	{
+		goto fail;
+	}
+
+	const long skip = comments + (long) (FLF_FIRST_NEEDED - FLF_FIRST_CHAR) * height;
+	for (long i = 0; i < skip && line < end; i++) { line = next_line(line, end); }
+
+	font->height = (unsigned short) height;
+
+	for (unsigned short glyph = 0; glyph < FONT_CHARSET_SIZE; glyph++)
+		for (unsigned short row = 0; row < height; row++)
+		{
+			if (line >= end) goto fail;
+
+			const unsigned short len = decode_row(line, end);
+			if (len > UCHAR_MAX) goto fail;
+
+			rows[glyph][row]          = line;
+			font->rowlen[glyph][row]  = (unsigned char) len;
+			if (len > font->stride) font->stride = len;
+
+			line = next_line(line, end);
+		}
+
+	if (font->stride == 0) goto fail;
+
+	/* only the glyphs are copied into the atlas, the mapping can go */
+	const size_t nrows = (size_t) FONT_CHARSET_SIZE * height;
+	if ((atlas = (char*) malloc(nrows * font->stride)) == NULL) goto fail;
+
+	memset(atlas, ' ', nrows * font->stride);
+	for (unsigned short glyph = 0; glyph < FONT_CHARSET_SIZE; glyph++)
+		for (unsigned short row = 0; row < height; row++)
+		{
+			char *dst = atlas + ((size_t) glyph * height + row) * font->stride;
+			memcpy(dst, rows[glyph][row], font->rowlen[glyph][row]);
+
+			for (unsigned short i = 0; i < font->rowlen[glyph][row]; i++)
+				if (dst[i] == hardblank) dst[i] = ' ';
+		}
+
+	munmap((void*) map, st.st_size);
+
+	font->atlas = atlas;
+	font->width = font->stride;
+	return font;
+
+fail:
+	free(font);
+	munmap((void*) map, st.st_size);
+	return NULL;
+}
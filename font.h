@@ -0,0 +1,71 @@
+#ifndef FT_FONT_H
+#define FT_FONT_H
+
+#define WIDEST_FONT            17
+#define FONT_CHARSET_SIZE      11
+
+#define COLON_INDEX            10
+
+#define FONT_DEFAULT           "short"
+
+/* Not a font: the largest one fitting the window gets picked (again
+ * on every resize), see font_fitting
+ */
+#define FONT_AUTO              "auto"
+#define FONT_FOOTPRINT_GLYPHS  8
+
+#include <stddef.h>
+
+/* Glyphs are packed row-major into a single block, every row takes
+ * 'stride' bytes (space padded) and 'rowlen' tells how many of them
+ * actually belong to the row. 'width' is the advance between glyphs
+ */
+struct font_t
+{
+	const char     *atlas;
+	unsigned char  rowlen[FONT_CHARSET_SIZE][WIDEST_FONT];
+	unsigned short height, width, stride;
+};
+
+/* Single source of truth about which fonts exist, lookups,
+ * listing and previews read from here
+ */
+struct font_entry
+{
+	const char          *name;
+	const struct font_t *font;
+	unsigned short      height, width;
+};
+
+/* Rows and columns a font takes to display FONT_FOOTPRINT_GLYPHS
+ * glyphs, precomputed so picking a font is a scan over a few shorts
+ */
+struct font_footprint
+{
+	unsigned char  index;
+	unsigned short height, width;
+};
+
+extern const struct font_entry FontTable[];
+extern const unsigned short    NoFonts;
+
+static inline const char *font_row (const struct font_t *font, const unsigned short glyph, const unsigned short row)
+{
+	return font->atlas + ((size_t) glyph * font->height + row) * font->stride;
+}
+
+/* Glyphs are clipped to the font width, which is the room every
+ * glyph has on screen, whatever is left is padded with spaces
+ */
+static inline unsigned short font_row_len (const struct font_t *font, const unsigned short glyph, const unsigned short row)
+{
+	const unsigned short len = font->rowlen[glyph][row];
+	return len < font->width ? len : font->width;
+}
+
+const struct font_t *font_lookup (const char*);
+const struct font_t *font_load_flf (const char*);
+const struct font_entry *font_fitting (const unsigned short, const unsigned short);
+const struct font_entry *font_smallest (void);
+
+#endif
@@ -1,681 +1,754 @@
-#pragma once
+#ifndef FT_FONTSET_H
+#define FT_FONTSET_H
 
-#define NO_FONTS 8
+/* Font definitions, only meant to be included by font.c
+ * generated by tools/mkfontset.py, do not edit by hand
+ */
 
-static const char *const FontNames[NO_FONTS] =
-{
-	"bulbhead",
-	"braced",
-	"fraktur",
-	"hollywood",
-	"larry3d",
-	"raw",
-	"rectangles",
-	"short (default)",
-};
+#define NO_FONTS 8
 
-static const struct font_t f_bulbhead =
+static const struct font_t f_braced =
 {
-	.set =
+	.atlas =
+	/* '0' */
+	" .---.  "
+	". .-. . "
+	"' `-' ' "
+	" `---'  "
+	/* '1' */
+	"  .-.   "
+	"  { |   "
+	"  | }   "
+	"  `-'   "
+	/* '2' */
+	".---.   "
+	"`-`} }  "
+	"{ {.-.  "
+	" `---'  "
+	/* '3' */
+	".---.   "
+	"`-`} }  "
+	".-.} }  "
+	"`----`  "
+	/* '4' */
+	".-. .-. "
+	" \\ \\| | "
+	"  `-\\ } "
+	"    `-' "
+	/* '5' */
+	" .---.  "
+	"{ {`-'  "
+	".-.} }  "
+	"`---'   "
+	/* '6' */
+	"  .-.   "
+	" / /.   "
+	"{ {} }  "
+	" `--'   "
+	/* '7' */
+	".---.   "
+	"`-`} }  "
+	"  / /   "
+	" `-'    "
+	/* '8' */
+	" .--.   "
+	"{ {} }  "
+	"{ {} }  "
+	" `--'   "
+	/* '9' */
+	" .--.   "
+	"{ {} }  "
+	" `/ /   "
+	" `-'    "
+	/* ':' */
+	" _      "
+	"{_}     "
+	" _      "
+	"{_}     "
+	,
+	.rowlen =
 	{
-		{
-		"  ___  ",
-		" / _ ` ",
-		"( (_) )",
-		" `___/ ",
-		},
-		{
-		"  __   ",
-		" /  )  ",
-		"  )(   ",
-		" (__)  ",
-		},
-		{
-		" ___   ",
-		"(__ `  ",
-		" / _/  ",
-		"(____) ",
-		},
-		{
-		"  ___  ",
-		" (__ ) ",
-		"  (_ ` ",
-		" (___/ ",
-		},
-		{
-		"  __   ",
-		" /. |  ",
-		"(_  _) ",
-		"  (_)  ",
-		},
-		{
-		"  ___  ",
-		" | __) ",
-		" |__ ` ",
-		" (___/ ",
-		},
-		{
-		"   _   ",
-		"  / )  ",
-		" / _ ` ",
-		" `___/ ",
-		},
-		{
-		"  ___  ",
-		" (__ ) ",
-		"  / /  ",
-		" (_/   ",
-		},
-		{
-		"  ___  ",
-		" ( _ ) ",
-		" / _ ` ",
-		" `___/ ",
-		},
-		{
-		"  ___  ",
-		" / _ ` ",
-		" `_  / ",
-		"  (_/  ",
-		},
-		{
-		"       ",
-		"   ()  ",
-		"       ",
-		"   ()  ",
-		}
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
+		{ 8, 8, 8, 8 },
 	},
 	.height = 4,
-	.width  = 7
+	.width  = 8,
+	.stride = 8
 };
 
-static const struct font_t f_braced =
+static const struct font_t f_bulbhead =
 {
-	.set =
+	.atlas =
+	/* '0' */
+	"  ___  "
+	" / _ ` "
+	"( (_) )"
+	" `___/ "
+	/* '1' */
+	"  __   "
+	" /  )  "
+	"  )(   "
+	" (__)  "
+	/* '2' */
+	" ___   "
+	"(__ `  "
+	" / _/  "
+	"(____) "
+	/* '3' */
+	"  ___  "
+	" (__ ) "
+	"  (_ ` "
+	" (___/ "
+	/* '4' */
+	"  __   "
+	" /. |  "
+	"(_  _) "
+	"  (_)  "
+	/* '5' */
+	"  ___  "
+	" | __) "
+	" |__ ` "
+	" (___/ "
+	/* '6' */
+	"   _   "
+	"  / )  "
+	" / _ ` "
+	" `___/ "
+	/* '7' */
+	"  ___  "
+	" (__ ) "
+	"  / /  "
+	" (_/   "
+	/* '8' */
+	"  ___  "
+	" ( _ ) "
+	" / _ ` "
+	" `___/ "
+	/* '9' */
+	"  ___  "
+	" / _ ` "
+	" `_  / "
+	"  (_/  "
+	/* ':' */
+	"       "
+	"   ()  "
+	"       "
+	"   ()  "
+	,
+	.rowlen =
 	{
-		{
-		" .---.  ",
-		". .-. . ",
-		"' `-' ' ",
-		" `---'  ",
-		},
-		{
-		"  .-.   ",
-		"  { |   ",
-		"  | }   ",
-		"  `-'   ",
-		},
-		{
-		".---.   ",
-		"`-`} }  ",
-		"{ {.-.  ",
-		" `---'  ",
-		},
-		{
-		".---.   ",
-		"`-`} }  ",
-		".-.} }  ",
-		"`----`  ",
-		},
-		{
-		".-. .-. ",
-		" \\ \\| | ",
-		"  `-\\ } ",
-		"    `-' ",
-		},
-		{
-		" .---.  ",
-		"{ {`-'  ",
-		".-.} }  ",
-		"`---'   ",
-		},
-		{
-		"  .-.   ",
-		" / /.   ",
-		"{ {} }  ",
-		" `--'   ",
-		},
-		{
-		".---.   ",
-		"`-`} }  ",
-		"  / /   ",
-		" `-'    ",
-		},
-		{
-		" .--.   ",
-		"{ {} }  ",
-		"{ {} }  ",
-		" `--'   ",
-		},
-		{
-		" .--.   ",
-		"{ {} }  ",
-		" `/ /   ",
-		" `-'    ",
-		},
-		{
-		" _      ",
-		"{_}     ",
-		" _      ",
-		"{_}     ",
-		}
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
+		{ 7, 7, 7, 7 },
 	},
 	.height = 4,
-	.width  = 8
+	.width  = 7,
+	.stride = 7
 };
 
 static const struct font_t f_fraktur =
 {
-        .set =
-        {
-                {
-                "    .n~~%x.     ",
-                "  x88X   888.   ",
-                " X888X   8888L  ",
-                "X8888X   88888  ",
-                "88888X   88888X ",
-                "88888X   88888X ",
-                "88888X   88888f ",
-                "48888X   88888  ",
-                " ?888X   8888\"  ",
-                "  \"88X   88*`   ",
-                "    ^\"===\"`     ",
-                },
-                {
-                "      oe        ",
-                "    .@88        ",
-                "==*88888        ",
-                "   88888        ",
-                "   88888        ",
-                "   88888        ",
-                "   88888        ",
-                "   88888        ",
-                "   88888        ",
-                "   88888        ",
-                "'**%%%%%%**     ",
-                },
-                {
-                "  .--~*teu.     ",
-                " dF     988Nx   ",
-                "d888b   `8888>  ",
-                "?8888>  98888F  ",
-                " \"**\"  x88888~  ",
-                "      d8888*`   ",
-                "    z8**\"`   :  ",
-                "  :?.....  ..F  ",
-                " <\"\"888888888~  ",
-                " 8:  \"888888*   ",
-                " \"\"    \"**\"`    ",
-                },
-                {
-                "  .x~~\"*Weu.    ",
-                " d8Nu.  9888c   ",
-                " 88888  98888   ",
-                " \"***\"  9888%   ",
-                "      ..@8*\"    ",
-                "   ````\"8Weu    ",
-                "  ..    ?8888L  ",
-                ":@88N   '8888N  ",
-                "*8888~  '8888F  ",
-                "'*8\"`   9888%   ",
-                "  `~===*%\"`     ",
-                },
-                {
-                "        xeee    ",
-                "       d888R    ",
-                "      d8888R    ",
-                "     @ 8888R    ",
-                "   .P  8888R    ",
-                "  :F   8888R    ",
-                " x\"    8888R    ",
-                "d8eeeee88888eer ",
-                "       8888R    ",
-                "       8888R    ",
-                "    \"*%%%%%%**~ ",
-                },
-                {
-                "  cuuu....uK    ",
-                "  888888888     ",
-                "  8*888**\"      ",
-                "  >  .....      ",
-                "  Lz\"  ^888Nu   ",
-                "  F     '8888k  ",
-                "  ..     88888> ",
-                " @888L   88888  ",
-                "'8888F   8888F  ",
-                " %8F\"   d888\"   ",
-                "  ^\"===*%\"`     ",
-                },
-                {
-                "    .ue~~%u.    ",
-                "  .d88   z88i   ",
-                " x888E  *8888   ",
-                ":8888E   ^\"\"    ",
-                "98888E.=tWc.    ",
-                "98888N  '888N   ",
-                "98888E   8888E  ",
-                "'8888E   8888E  ",
-                " ?888E   8888\"  ",
-                "  \"88&   888\"   ",
-                "    \"\"==*\"\"     ",
-                },
-                {
-                "dL ud8Nu  :8c   ",
-                "8Fd888888L %8   ",
-                "4N88888888cuR   ",
-                "4F   ^\"\"%\"\"d    ",
-                "d       .z8     ",
-                "^     z888      ",
-                "    d8888'      ",
-                "   888888       ",
-                "  :888888       ",
-                "   888888       ",
-                "   '%**%        ",
-                },
-                {
-                "   u+=~~~+u.    ",
-                " z8F      `8N.  ",
-                "d88L       98E  ",
-                "98888bu.. .@*   ",
-                "\"88888888NNu.   ",
-                " \"*8888888888i  ",
-                " .zf\"\"*8888888L ",
-                "d8F      ^%888E ",
-                "88>        `88~ ",
-                "'%N.       d*\"  ",
-                "   ^\"=====\"`    ",
-                },
-                {
-                "  .xn!~%x.      ",
-                " x888   888.    ",
-                "X8888   8888:   ",
-                "88888   X8888   ",
-                "88888   88888>  ",
-                "`8888  :88888X  ",
-                "  `\"**~ 88888>  ",
-                " .xx.   88888   ",
-                "'8888>  8888~   ",
-                " 888\"  :88%     ",
-                "  ^\"===\"\"       ",
-                },
-                {
-                "   .            ",
-                "  d8c           ",
-                "^*888%          ",
-                "  \"8            ",
-                "                ",
-                "   .            ",
-                " .@8c           ",
-                "'%888\"          ",
-                "  ^*            ",
-                "                ",
-                "                ",
-                }
-        },
+	.atlas =
+	/* '0' */
+	"    .n~~%x.     "
+	"  x88X   888.   "
+	" X888X   8888L  "
+	"X8888X   88888  "
+	"88888X   88888X "
+	"88888X   88888X "
+	"88888X   88888f "
+	"48888X   88888  "
+	" ?888X   8888\"  "
+	"  \"88X   88*`   "
+	"    ^\"===\"`     "
+	/* '1' */
+	"      oe        "
+	"    .@88        "
+	"==*88888        "
+	"   88888        "
+	"   88888        "
+	"   88888        "
+	"   88888        "
+	"   88888        "
+	"   88888        "
+	"   88888        "
+	"'**%%%%%%**     "
+	/* '2' */
+	"  .--~*teu.     "
+	" dF     988Nx   "
+	"d888b   `8888>  "
+	"?8888>  98888F  "
+	" \"**\"  x88888~  "
+	"      d8888*`   "
+	"    z8**\"`   :  "
+	"  :?.....  ..F  "
+	" <\"\"888888888~  "
+	" 8:  \"888888*   "
+	" \"\"    \"**\"`    "
+	/* '3' */
+	"  .x~~\"*Weu.    "
+	" d8Nu.  9888c   "
+	" 88888  98888   "
+	" \"***\"  9888%   "
+	"      ..@8*\"    "
+	"   ````\"8Weu    "
+	"  ..    ?8888L  "
+	":@88N   '8888N  "
+	"*8888~  '8888F  "
+	"'*8\"`   9888%   "
+	"  `~===*%\"`     "
+	/* '4' */
+	"        xeee    "
+	"       d888R    "
+	"      d8888R    "
+	"     @ 8888R    "
+	"   .P  8888R    "
+	"  :F   8888R    "
+	" x\"    8888R    "
+	"d8eeeee88888eer "
+	"       8888R    "
+	"       8888R    "
+	"    \"*%%%%%%**~ "
+	/* '5' */
+	"  cuuu....uK    "
+	"  888888888     "
+	"  8*888**\"      "
+	"  >  .....      "
+	"  Lz\"  ^888Nu   "
+	"  F     '8888k  "
+	"  ..     88888> "
+	" @888L   88888  "
+	"'8888F   8888F  "
+	" %8F\"   d888\"   "
+	"  ^\"===*%\"`     "
+	/* '6' */
+	"    .ue~~%u.    "
+	"  .d88   z88i   "
+	" x888E  *8888   "
+	":8888E   ^\"\"    "
+	"98888E.=tWc.    "
+	"98888N  '888N   "
+	"98888E   8888E  "
+	"'8888E   8888E  "
+	" ?888E   8888\"  "
+	"  \"88&   888\"   "
+	"    \"\"==*\"\"     "
+	/* '7' */
+	"dL ud8Nu  :8c   "
+	"8Fd888888L %8   "
+	"4N88888888cuR   "
+	"4F   ^\"\"%\"\"d    "
+	"d       .z8     "
+	"^     z888      "
+	"    d8888'      "
+	"   888888       "
+	"  :888888       "
+	"   888888       "
+	"   '%**%        "
+	/* '8' */
+	"   u+=~~~+u.    "
+	" z8F      `8N.  "
+	"d88L       98E  "
+	"98888bu.. .@*   "
+	"\"88888888NNu.   "
+	" \"*8888888888i  "
+	" .zf\"\"*8888888L "
+	"d8F      ^%888E "
+	"88>        `88~ "
+	"'%N.       d*\"  "
+	"   ^\"=====\"`    "
+	/* '9' */
+	"  .xn!~%x.      "
+	" x888   888.    "
+	"X8888   8888:   "
+	"88888   X8888   "
+	"88888   88888>  "
+	"`8888  :88888X  "
+	"  `\"**~ 88888>  "
+	" .xx.   88888   "
+	"'8888>  8888~   "
+	" 888\"  :88%     "
+	"  ^\"===\"\"       "
+	/* ':' */
+	"   .            "
+	"  d8c           "
+	"^*888%          "
+	"  \"8            "
+	"                "
+	"   .            "
+	" .@8c           "
+	"'%888\"          "
+	"  ^*            "
+	"                "
+	"                "
+	,
+	.rowlen =
+	{
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+		{ 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16 },
+	},
 	.height = 11,
-	.width  = 16
+	.width  = 16,
+	.stride = 16
 };
 
 static const struct font_t f_hollywood =
 {
-	.set =
+	.atlas =
+	/* '0' */
+	"          /' `\\  "
+	"        /'     ) "
+	"      /'      /' "
+	"    /'      /'   "
+	"  /'      /'     "
+	" (_____,/'       "
+	"                 "
+	/* '1' */
+	"           _     "
+	"       _--~/'    "
+	"      ~  /'      "
+	"       /'        "
+	"     /'          "
+	"   /'            "
+	" /'              "
+	/* '2' */
+	"         _       "
+	"      _-~ `\\     "
+	"     (      )    "
+	"         _/~     "
+	"      _/~        "
+	"   _/~           "
+	" /~____,/        "
+	/* '3' */
+	"            _    "
+	"          /' `\\  "
+	"              _) "
+	"        .__--~   "
+	"           ;     "
+	"          /'     "
+	" (_____,/'       "
+	/* '4' */
+	"          _      "
+	"      _--~/'     "
+	"  _--~  /'       "
+	" -~____/__       "
+	"     /'          "
+	"   /'            "
+	" /'              "
+	/* '5' */
+	"            _    "
+	"          /' `\\  "
+	"        /'     ` "
+	"       (____     "
+	"            )    "
+	"          /'     "
+	" (_____,/'       "
+	/* '6' */
+	"            _    "
+	"          /' `\\  "
+	"        /'     ) "
+	"      /_____     "
+	"    /'      )    "
+	"  /'      /'     "
+	" (_____,/'       "
+	/* '7' */
+	"          _______"
+	"         (     _/"
+	"            _/~  "
+	"        \\_/~     "
+	"      _/~\\       "
+	"   _/~           "
+	" /~              "
+	/* '8' */
+	"            _    "
+	"          /' `\\  "
+	"        /'     ) "
+	"      _(_____,/  "
+	"    /'     )     "
+	"  /'      /'     "
+	" (_____,/'       "
+	/* '9' */
+	"      _          "
+	"    /' `\\        "
+	"  /'     )       "
+	" (_____ /        "
+	"      /'         "
+	"    /'           "
+	"  /'             "
+	/* ':' */
+	"                 "
+	"                 "
+	"     O           "
+	"                 "
+	" O               "
+	"                 "
+	"                 "
+	,
+	.rowlen =
 	{
-		{
-		"          /' `\\  ",
-		"        /'     ) ",
-		"      /'      /' ",
-		"    /'      /'   ",
-		"  /'      /'     ",
-		" (_____,/'       ",
-		"                 "
-		},
-		{
-		"           _     ",
-		"       _--~/'    ",
-		"      ~  /'      ",
-		"       /'        ",
-		"     /'          ",
-		"   /'            ",
-		" /'              ",
-		},
-		{
-		"         _       ",
-		"      _-~ `\\     ",
-		"     (      )    ",
-		"         _/~     ",
-		"      _/~        ",
-		"   _/~           ",
-		" /~____,/        ",
-		},
-		{
-		"            _    ",
-		"          /' `\\  ",
-		"              _) ",
-		"        .__--~   ",
-		"           ;     ",
-		"          /'     ",
-		" (_____,/'       ",
-		},
-		{
-		"          _      ",
-		"      _--~/'     ",
-		"  _--~  /'       ",
-		" -~____/__       ",
-		"     /'          ",
-		"   /'            ",
-		" /'              ",
-		},
-		{
-		"            _    ",
-		"          /' `\\  ",
-		"        /'     ` ",
-		"       (____     ",
-		"            )    ",
-		"          /'     ",
-		" (_____,/'       ",
-		},
-		{
-		"            _    ",
-		"          /' `\\  ",
-		"        /'     ) ",
-		"      /_____     ",
-		"    /'      )    ",
-		"  /'      /'     ",
-		" (_____,/'       ",
-		},
-		{
-		"          _______",
-		"         (     _/",
-		"            _/~  ",
-		"        \\_/~     ",
-		"      _/~\\       ",
-		"   _/~           ",
-		" /~              ",
-		},
-		{
-		"            _    ",
-		"          /' `\\  ",
-		"        /'     ) ",
-		"      _(_____,/  ",
-		"    /'     )     ",
-		"  /'      /'     ",
-		" (_____,/'       ",
-		},
-		{
-		"      _          ",
-		"    /' `\\        ",
-		"  /'     )       ",
-		" (_____ /        ",
-		"      /'         ",
-		"    /'           ",
-		"  /'             ",
-		},
-		{
-		"                 ",
-		"                 ",
-		"     O           ",
-		"                 ",
-		" O               ",
-		"                 ",
-		"                 ",
-		}
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
+		{ 17, 17, 17, 17, 17, 17, 17 },
 	},
 	.height = 7,
-	.width  = 17
+	.width  = 17,
+	.stride = 17
 };
 
 static const struct font_t f_larry3d =
 {
-	.set =
+	.atlas =
+	/* '0' */
+	"   __      "
+	" /'__``    "
+	"/` `/` `   "
+	"` ` ` ` `  "
+	" ` ` `_` ` "
+	"  ` `____/ "
+	"   `/___/  "
+	/* '1' */
+	"   _       "
+	" /' `      "
+	"/`_, `     "
+	"`/_/` `    "
+	"   ` ` `   "
+	"    ` `_`  "
+	"     `/_/  "
+	/* '2' */
+	"   ___     "
+	" /'___``   "
+	"/`_` /` `  "
+	"`/_/// /__ "
+	"   // /_` `"
+	"  /`______/"
+	"  `/_____/ "
+	/* '3' */
+	"   __      "
+	" /'__``    "
+	"/`_`L` `   "
+	"`/_/_`_<_  "
+	"  /` `L` ` "
+	"  ` `____/ "
+	"   `/___/  "
+	/* '4' */
+	" __ __     "
+	"/` `` `    "
+	"` ` `` `   "
+	" ` ` `` `_ "
+	"  ` `__ ,__"
+	"   `/_/`_`_"
+	"      `/_/ "
+	/* '5' */
+	" ______    "
+	"/`  ___`   "
+	"` ` `__/   "
+	" ` `___``` "
+	"  `/` `L` `"
+	"   ` `____/"
+	"    `/___/ "
+	/* '6' */
+	"  ____     "
+	" /'___`    "
+	"/` `__/    "
+	"` `  _```  "
+	" ` ` `L` ` "
+	"  ` `____/ "
+	"   `/___/  "
+	/* '7' */
+	" ________  "
+	"/`_____  ` "
+	"`/___//'/' "
+	"    /' /'  "
+	"  /' /'    "
+	" /`_/      "
+	" `//       "
+	/* '8' */
+	"   __      "
+	" /'_ ``    "
+	"/` `L` `   "
+	"`/_> _ <_  "
+	"  /` `L` ` "
+	"  ` `____/ "
+	"   `/___/  "
+	/* '9' */
+	"   __      "
+	" /'_ ``    "
+	"/` `L` `   "
+	"` `___, `  "
+	" `/__,/` ` "
+	"      ` `_`"
+	"       `/_/"
+	/* ':' */
+	"           "
+	" __        "
+	"/`_`       "
+	"`/_/_      "
+	"  /`_`     "
+	"  `/_/     "
+	"           "
+	,
+	.rowlen =
 	{
-		{
-		"   __      ",
-		" /'__``    ",
-		"/` `/` `   ",
-		"` ` ` ` `  ",
-		" ` ` `_` ` ",
-		"  ` `____/ ",
-		"   `/___/  ",
-		},
-		{
-		"   _       ",
-		" /' `      ",
-		"/`_, `     ",
-		"`/_/` `    ",
-		"   ` ` `   ",
-		"    ` `_`  ",
-		"     `/_/  ",
-		},
-		{
-		"   ___     ",
-		" /'___``   ",
-		"/`_` /` `  ",
-		"`/_/// /__ ",
-		"   // /_` `",
-		"  /`______/",
-		"  `/_____/ ",
-		},
-		{
-		"   __      ",
-		" /'__``    ",
-		"/`_`L` `   ",
-		"`/_/_`_<_  ",
-		"  /` `L` ` ",
-		"  ` `____/ ",
-		"   `/___/  ",
-		},
-		{
-		" __ __     ",
-		"/` `` `    ",
-		"` ` `` `   ",
-		" ` ` `` `_ ",
-		"  ` `__ ,__",
-		"   `/_/`_`_",
-		"      `/_/ ",
-		},
-		{
-		" ______    ",
-		"/`  ___`   ",
-		"` ` `__/   ",
-		" ` `___``` ",
-		"  `/` `L` `",
-		"   ` `____/",
-		"    `/___/ ",
-		},
-		{
-		"  ____     ",
-		" /'___`    ",
-		"/` `__/    ",
-		"` `  _```  ",
-		" ` ` `L` ` ",
-		"  ` `____/ ",
-		"   `/___/  ",
-		},
-		{
-		" ________  ",
-		"/`_____  ` ",
-		"`/___//'/' ",
-		"    /' /'  ",
-		"  /' /'    ",
-		" /`_/      ",
-		" `//       ",
-		},
-		{
-		"   __      ",
-		" /'_ ``    ",
-		"/` `L` `   ",
-		"`/_> _ <_  ",
-		"  /` `L` ` ",
-		"  ` `____/ ",
-		"   `/___/  ",
-		},
-		{
-		"   __      ",
-		" /'_ ``    ",
-		"/` `L` `   ",
-		"` `___, `  ",
-		" `/__,/` ` ",
-		"      ` `_`",
-		"       `/_/",
-		},
-		{
-		"           ",
-		" __        ",
-		"/`_`       ",
-		"`/_/_      ",
-		"  /`_`     ",
-		"  `/_/     ",
-		"           "
-		}
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
+		{ 11, 11, 11, 11, 11, 11, 11 },
 	},
 	.height = 7,
-	.width  = 11
+	.width  = 11,
+	.stride = 11
 };
 
 static const struct font_t f_raw =
 {
-	.set =
+	.atlas =
+	/* '0' */
+	"0"
+	/* '1' */
+	"1"
+	/* '2' */
+	"2"
+	/* '3' */
+	"3"
+	/* '4' */
+	"4"
+	/* '5' */
+	"5"
+	/* '6' */
+	"6"
+	/* '7' */
+	"7"
+	/* '8' */
+	"8"
+	/* '9' */
+	"9"
+	/* ':' */
+	":"
+	,
+	.rowlen =
 	{
-		{ "0" },
-		{ "1" },
-		{ "2" },
-		{ "3" },
-		{ "4" },
-		{ "5" },
-		{ "6" },
-		{ "7" },
-		{ "8" },
-		{ "9" },
-		{ ":" }
+		{ 1 },
+		{ 1 },
+		{ 1 },
+		{ 1 },
+		{ 1 },
+		{ 1 },
+		{ 1 },
+		{ 1 },
+		{ 1 },
+		{ 1 },
+		{ 1 },
 	},
 	.height = 1,
-	.width  = 1
+	.width  = 1,
+	.stride = 1
 };
 
 static const struct font_t f_rectangles =
 {
-	.set =
+	.atlas =
+	/* '0' */
+	" ___  "
+	"|   | "
+	"| | | "
+	"|___| "
+	/* '1' */
+	" ___  "
+	"|_  | "
+	"  | | "
+	"  |_| "
+	/* '2' */
+	" ___  "
+	"|_  | "
+	"|  _| "
+	"|___| "
+	/* '3' */
+	" ___  "
+	"|_  | "
+	"|_  | "
+	"|___| "
+	/* '4' */
+	" ___  "
+	"| | | "
+	"|_  | "
+	"  |_| "
+	/* '5' */
+	" ___  "
+	"|  _| "
+	"|_  | "
+	"|___| "
+	/* '6' */
+	" ___  "
+	"|  _| "
+	"| . | "
+	"|___| "
+	/* '7' */
+	" ___  "
+	"|_  | "
+	"  | | "
+	"  |_| "
+	/* '8' */
+	" ___  "
+	"| . | "
+	"| . | "
+	"|___| "
+	/* '9' */
+	" ___  "
+	"| . | "
+	"|_  | "
+	"|___| "
+	/* ':' */
+	"  _   "
+	" |_|  "
+	"  _   "
+	" |_|  "
+	,
+	.rowlen =
 	{
-		{
-		" ___  ",
-		"|   | ",
-		"| | | ",
-		"|___| ",
-		},
-		{
-		" ___  ",
-		"|_  | ",
-		"  | | ",
-		"  |_| ",
-		},
-		{
-		" ___  ",
-		"|_  | ",
-		"|  _| ",
-		"|___| ",
-		},
-		{
-		" ___  ",
-		"|_  | ",
-		"|_  | ",
-		"|___| ",
-		},
-		{
-		" ___  ",
-		"| | | ",
-		"|_  | ",
-		"  |_| ",
-		},
-		{
-		" ___  ",
-		"|  _| ",
-		"|_  | ",
-		"|___| ",
-		},
-		{
-		" ___  ",
-		"|  _| ",
-		"| . | ",
-		"|___| ",
-		},
-		{
-		" ___  ",
-		"|_  | ",
-		"  | | ",
-		"  |_| ",
-		},
-		{
-		" ___  ",
-		"| . | ",
-		"| . | ",
-		"|___| ",
-		},
-		{
-		" ___  ",
-		"| . | ",
-		"|_  | ",
-		"|___| ",
-		},
-		{
-		"  _   ",
-		" |_|  ",
-		"  _   ",
-		" |_|  ",
-		}
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
+		{ 6, 6, 6, 6 },
 	},
 	.height = 4,
-	.width  = 5
+	.width  = 5,
+	.stride = 6
 };
 
 static const struct font_t f_short =
 {
-	.set =
+	.atlas =
+	/* '0' */
+	"/\\ "
+	"\\/ "
+	/* '1' */
+	"'| "
+	"_|_"
+	/* '2' */
+	"') "
+	"/_ "
+	/* '3' */
+	"') "
+	".) "
+	/* '4' */
+	"/| "
+	"~|~"
+	/* '5' */
+	"|~ "
+	"_) "
+	/* '6' */
+	" / "
+	"(_)"
+	/* '7' */
+	"~/ "
+	"/  "
+	/* '8' */
+	"(~)"
+	"(_)"
+	/* '9' */
+	"(~)"
+	" / "
+	/* ':' */
+	" . "
+	" . "
+	,
+	.rowlen =
 	{
-		{
-		"/\\ ",
-		"\\/ ",
-		},
-		{
-		"'| ",
-		"_|_",
-		},
-		{
-		"') ",
-		"/_ ",
-		},
-		{
-		"') ",
-		".) ",
-		},
-		{
-		"/| ",
-		"~|~",
-		},
-		{
-		"|~ ",
-		"_) ",
-		},
-		{
-		" / ",
-		"(_)",
-		},
-		{
-		"~/ ",
-		"/  ",
-		},
-		{
-		"(~)",
-		"(_)",
-		},
-		{
-		"(~)",
-		" / ",
-		},
-		{
-		" . ",
-		" . ",
-		}
+		{ 3, 3 },
+		{ 3, 3 },
+		{ 3, 3 },
+		{ 3, 3 },
+		{ 3, 3 },
+		{ 3, 3 },
+		{ 3, 3 },
+		{ 3, 3 },
+		{ 3, 3 },
+		{ 3, 3 },
+		{ 3, 3 },
 	},
 	.height = 2,
-	.width  = 3
+	.width  = 3,
+	.stride = 3
 };
+
+const struct font_entry FontTable[NO_FONTS] =
+{
+	{ "braced",     &f_braced,      4,  8 },
+	{ "bulbhead",   &f_bulbhead,    4,  7 },
+	{ "fraktur",    &f_fraktur,    11, 16 },
+	{ "hollywood",  &f_hollywood,   7, 17 },
+	{ "larry3d",    &f_larry3d,     7, 11 },
+	{ "raw",        &f_raw,         1,  1 },
+	{ "rectangles", &f_rectangles,  4,  5 },
+	{ "short",      &f_short,       2,  3 },
+};
+
+/* Room every font needs to show hh:mm:ss, largest first */
+static const struct font_footprint FontFootprint[NO_FONTS] =
+{
+	{  2, 11, 128 }, /* fraktur */
+	{  3,  7, 136 }, /* hollywood */
+	{  4,  7,  88 }, /* larry3d */
+	{  0,  4,  64 }, /* braced */
+	{  1,  4,  56 }, /* bulbhead */
+	{  6,  4,  40 }, /* rectangles */
+	{  7,  2,  24 }, /* short */
+	{  5,  1,   8 }, /* raw */
+};
+
+/* Perfect hash over FontTable names */
+#define FONT_HASH_BUCKETS 4
+#define FONT_HASH_SIZE    16
+
+static const uint32_t FontDisp[FONT_HASH_BUCKETS] = { 3, 1, 5, 1 };
+static const short    FontSlot[FONT_HASH_SIZE]    = { -1, -1, -1, 1, -1, 4, 6, 0, -1, 3, 5, -1, -1, 2, 7, -1 };
+
+#endif
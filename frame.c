@@ -0,0 +1,253 @@
+#include "frame.h"
+#include "tick.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Moving the cursor costs at least 6 bytes, so when the next changed
+ * cell lies this close on the same line it is cheaper to resend the
+ * unchanged cells in between
+ */
+#define FRAME_MAX_GAP      6
+
+static const struct cell Blank = { .ch = ' ', .attr = FRAME_ATTR_NONE };
+
+static inline void promote (struct frame *fr)
+{
+	/* only ever called with nothing queued behind the frame which
+	 * is now in flight, 'front' is where that one leaves the screen
+	 */
+	memcpy(fr->shown, fr->front, (size_t) fr->height * fr->width * sizeof(struct cell));
+}
+
+static void *xrealloc (void *ptr, const size_t size)
+{
+	void *new = realloc(ptr, size);
+	if (new == NULL)
+	{
+		fprintf(stderr, "%s: error: out of memory\n", PROGRAM_NAME);
+		exit(EXIT_FAILURE);
+	}
+	return new;
+}
+
+static inline void reserve (struct frame *fr, const size_t more)
+{
+	if (fr->len + more <= fr->cap) return;
+
+	while (fr->len + more > fr->cap) { fr->cap = fr->cap ? fr->cap << 1 : 4096; }
+	fr->out = (char*) xrealloc(fr->out, fr->cap);
+}
+
+static inline void append (struct frame *fr, const char *bytes, const size_t n)
+{
+	reserve(fr, n);
+	memcpy(fr->out + fr->len, bytes, n);
+	fr->len += n;
+}
+
+static inline void append_uint (struct frame *fr, unsigned int n)
+{
+	char digits[10];
+	unsigned short i = sizeof(digits);
+
+	do { digits[--i] = '0' + n % 10; n /= 10; } while (n);
+	append(fr, digits + i, sizeof(digits) - i);
+}
+
+static inline void move_to (struct frame *fr, const unsigned short y, const unsigned short x)
+{
+	append(fr, "\x1b[", 2);
+	append_uint(fr, y + 1);
+	append(fr, ";", 1);
+	append_uint(fr, x + 1);
+	append(fr, "H", 1);
+}
+
+static inline void set_pen (struct frame *fr, const unsigned char attr)
+{
+	append(fr, "\x1b[0", 3);
+	if (attr & FRAME_ATTR_BOLD)  { append(fr, ";1", 2); }
+	if (attr & FRAME_ATTR_DIM)   { append(fr, ";2", 2); }
+	if (attr & FRAME_ATTR_BLINK) { append(fr, ";5", 2); }
+	append(fr, "m", 1);
+}
+
+void frame_resize (struct frame *fr, const unsigned short height, const unsigned short width)
+{
+	const size_t cells = (size_t) height * width;
+
+	fr->front  = (struct cell*) xrealloc(fr->front, cells * sizeof(struct cell));
+	fr->back   = (struct cell*) xrealloc(fr->back,  cells * sizeof(struct cell));
+	fr->shown  = (struct cell*) xrealloc(fr->shown, cells * sizeof(struct cell));
+	fr->height = height;
+	fr->width  = width;
+	fr->stale  = TRUE;
+
+	for (size_t i = 0; i < cells; i++) { fr->front[i] = fr->back[i] = fr->shown[i] = Blank; }
+}
+
+void frame_puts (struct frame *fr, const unsigned short y, const unsigned short x, const char *str, const size_t len, const unsigned char attr)
+{
+	if (y >= fr->height || x >= fr->width) return;
+
+	const size_t room = fr->width - x;
+	struct cell *row  = fr->back + (size_t) y * fr->width + x;
+
+	for (size_t i = 0; i < len && i < room; i++)
+	{
+		row[i].ch   = str[i];
+		row[i].attr = attr;
+	}
+}
+
+void frame_fill (struct frame *fr, const unsigned short y, const unsigned short x, const size_t len)
+{
+	if (y >= fr->height || x >= fr->width) return;
+
+	const size_t room = fr->width - x;
+	struct cell *row  = fr->back + (size_t) y * fr->width + x;
+
+	for (size_t i = 0; i < len && i < room; i++) { row[i] = Blank; }
+}
+
+void frame_emit (struct frame *fr, const char *bytes, const size_t n)
+{
+	append(fr, bytes, n);
+}
+
+void frame_mark (struct frame *fr, const unsigned short y, const unsigned short x, const size_t len)
+{
+	if (y >= fr->height || x >= fr->width) return;
+
+	const size_t at = (size_t) y * fr->width + x;
+	const size_t n  = len < (size_t) (fr->width - x) ? len : (size_t) (fr->width - x);
+
+	memcpy(fr->front + at, fr->back + at, n * sizeof(struct cell));
+}
+
+void frame_supersede (struct frame *fr)
+{
+	/* a queued frame the terminal has not started on yet is of no
+	 * use once a newer one is about to be composed, the newer one is
+	 * diffed against the frame in flight instead. That one goes out
+	 * whole (or the terminal could be left in the middle of an escape
+	 * sequence)
+	 */
+	if (fr->queued <= fr->head) return;
+
+	fr->len = fr->queued = fr->head;
+	fr->dropped++;
+
+	memcpy(fr->front, fr->shown, (size_t) fr->height * fr->width * sizeof(struct cell));
+}
+
+void frame_flush (struct frame *fr, const int fd)
+{
+	/* anything emitted before is meaningless over a screen which is
+	 * about to be cleared, the cells are in the back buffer anyway
+	 */
+	if (fr->stale)
+	{
+		fr->len = fr->queued;
+		append(fr, "\x1b[0m\x1b[H\x1b[2J", 11);
+	}
+
+	unsigned char pen = FRAME_ATTR_NONE;
+	int cy = -1, cx = -1;
+
+	for (unsigned short y = 0; y < fr->height; y++)
+	{
+		const struct cell *front = fr->front + (size_t) y * fr->width;
+		const struct cell *back  = fr->back  + (size_t) y * fr->width;
+
+		if (!memcmp(front, back, fr->width * sizeof(struct cell))) continue;
+
+		for (unsigned short x = 0; x < fr->width; x++)
+		{
+			if (front[x].ch == back[x].ch && front[x].attr == back[x].attr) continue;
+
+			if (cy == y && cx <= x && x - cx <= FRAME_MAX_GAP)
+			{
+				/* bridge the gap with what is already on screen */
+				for (; cx < x; cx++)
+				{
+					if (back[cx].attr != pen) { set_pen(fr, pen = back[cx].attr); }
+					append(fr, &back[cx].ch, 1);
+				}
+			}
+			else
+			{
+				move_to(fr, y, x);
+			}
+
+			if (back[x].attr != pen) { set_pen(fr, pen = back[x].attr); }
+			append(fr, &back[x].ch, 1);
+
+			cy = y;
+			cx = x + 1;
+		}
+	}
+
+	if (pen != FRAME_ATTR_NONE) { set_pen(fr, FRAME_ATTR_NONE); }
+
+	memcpy(fr->front, fr->back, (size_t) fr->height * fr->width * sizeof(struct cell));
+	fr->stale = FALSE;
+
+	fr->bytes += fr->len - fr->queued;
+	if (!fr->head) { fr->head = fr->len; promote(fr); }
+	fr->queued = fr->len;
+	fr->frames++;
+
+	fr->blocked = 0;
+	frame_drain(fr, fd);
+}
+
+bool_t frame_drain (struct frame *fr, const int fd)
+{
+	if (fd == FRAME_NO_FD) fr->sent = fr->queued;
+
+	const int64_t begin = tick_now();
+	while (fr->sent < fr->queued)
+	{
+		const ssize_t w = write(fd, fr->out + fr->sent, fr->queued - fr->sent);
+		fr->writes++;
+		if (w == -1)
+		{
+			if (errno == EINTR) continue;
+			/* the rest waits for the terminal to catch up, unless
+			 * there is no terminal to wait for anymore
+			 */
+			if (errno != EAGAIN) fr->sent = fr->queued;
+			break;
+		}
+		fr->sent += (size_t) w;
+	}
+	fr->blocked += tick_now() - begin;
+
+	/* once the frame in flight is out the newer one (if any) takes
+	 * its place at the beginning of the queue
+	 */
+	if (fr->sent >= fr->head)
+	{
+		if (fr->queued > fr->head) promote(fr);
+		memmove(fr->out, fr->out + fr->head, fr->len - fr->head);
+		fr->len    -= fr->head;
+		fr->queued -= fr->head;
+		fr->sent   -= fr->head;
+		fr->head    = fr->queued;
+	}
+	return !frame_pending(fr);
+}
+
+void frame_free (struct frame *fr)
+{
+	free(fr->front);
+	free(fr->back);
+	free(fr->shown);
+	free(fr->out);
+	memset(fr, 0, sizeof(*fr));
+}
@@ -0,0 +1,76 @@
+#ifndef FT_FRAME_H
+#define FT_FRAME_H
+
+#include "common.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Attributes a single cell can be rendered with, they are
+ * translated into SGR sequences only when the pen changes
+ */
+#define FRAME_ATTR_NONE    0x00
+#define FRAME_ATTR_BOLD    0x01
+#define FRAME_ATTR_DIM     0x02
+#define FRAME_ATTR_BLINK   0x04
+
+/* Headless sink: frames are composed and encoded as usual but the
+ * bytes are dropped right before reaching write(2)
+ */
+#define FRAME_NO_FD        -1
+
+struct cell
+{
+	char          ch;
+	unsigned char attr;
+};
+
+/* Off-screen grid of cells: 'back' is where a frame gets composed,
+ * 'front' is what is believed to be on screen. Flushing diffs both
+ * and sends only the cells that changed in a single write(2).
+ * 'shown' is what the screen holds once the frame in flight is out,
+ * a superseded frame is forgotten by going back to it
+ *
+ * 'out' doubles as the output queue of a non-blocking terminal:
+ * [0, head) is the frame being written ('sent' bytes of it so far),
+ * [head, queued) at most one newer frame nothing of which was sent,
+ * [queued, len) whatever is being composed right now
+ */
+struct frame
+{
+	struct cell    *front, *back, *shown;
+	char           *out;
+	size_t         len, cap;
+	size_t         sent, head, queued;
+	unsigned short height, width;
+	/* the screen cannot be trusted (first frame or after resize),
+	 * it gets cleared within the very same write
+	 */
+	bool_t         stale;
+	/* what has been sent so far, kept across resizes */
+	uint64_t       frames, writes, bytes, dropped;
+	/* ns the last flush spent inside write(2) */
+	int64_t        blocked;
+};
+
+void frame_resize (struct frame*, const unsigned short, const unsigned short);
+void frame_puts (struct frame*, const unsigned short, const unsigned short, const char*, const size_t, const unsigned char);
+void frame_fill (struct frame*, const unsigned short, const unsigned short, const size_t);
+
+/* Fast path for content whose encoding is already known: the bytes
+ * are queued as they are, the cells they draw must be composed as
+ * usual and then marked so the next diff does not send them again
+ */
+void frame_emit (struct frame*, const char*, const size_t);
+void frame_mark (struct frame*, const unsigned short, const unsigned short, const size_t);
+void frame_supersede (struct frame*);
+void frame_flush (struct frame*, const int);
+bool_t frame_drain (struct frame*, const int);
+void frame_free (struct frame*);
+
+static inline bool_t frame_pending (const struct frame *fr)
+{
+	return fr->sent < fr->queued;
+}
+
+#endif
@@ -1,51 +1,111 @@
 #include "front.h"
+#include "back.h"
 #include "common.h"
-
+#include "tick.h"
+#include "screen.h"
+#include "status.h"
+#include "hist.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <termios.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
+#include <sys/signalfd.h>
 
 #define INTRO_ANSI             "\x1b[?1049h\x1b[?25l\x1b[H"
 #define OUTRO_ANSI             "\x1b[?1049l\x1b[?25h"
 
-#define WIDEST_FONT            17
-#define FONT_CHARSET_SIZE      11
-
-/* Number of characters defined within a font_t
- * to be displayed in screen xx:xx:xx (8)
+/* Seconds of work between two journal checkpoints, a crash can
+ * only lose this much (plus whatever is still batched)
  */
-#define RENDER_CHARSET_SIZE    8
-/* Besides the time left/passed we need to display
- * other information, this number indicates how many
- * lines are going to be used
- */
-#define EXTRA_RENDERED_LINES   3
+#define CHECKPOINT_EVERY       30
 
-#define COLON_INDEX            10
+/* Seconds added to the session by '+' */
+#define EXTEND_BY              (5 * 60)
 
-struct font_t
+/* Keys exactly as read(2) left them, every wakeup consumes all of
+ * them in a single pass (a pasted burst included)
+ */
+#define KEYS_RING_SIZE         256
+
+struct keyring
 {
-	char *set[FONT_CHARSET_SIZE][WIDEST_FONT];
-	unsigned short height, width;
+	unsigned char bytes[KEYS_RING_SIZE];
+	/* free running, masked on access */
+	unsigned int  head, tail;
 };
 
-#include "fontset.h"
+/* Plan files: one 'task, minutes, font' block per line, minutes and
+ * font may be left empty (command line defaults), '#' starts a comment
+ */
+#define PLAN_STDIN             "-"
+#define PLAN_SEPARATOR         ','
+#define PLAN_COMMENT           '#'
+
+/* What the hot path measures about itself, dumped to --stats-out on
+ * exit and whenever SIGUSR1 arrives (the screen thread keeps its own)
+ */
+struct probes
+{
+	struct hist late;
+	const char  *path;
+};
 
 struct front
 {
 	struct termios deftty;
-	struct font_t  font;
+	struct tick    tick;
+	struct screen  screen;
+	/* bumped whenever the screen has to be laid out again */
+	uint32_t       layout;
+	struct journal journal;
+	/* what status bars and --status get to see */
+	struct status_map status;
+	/* single wait point for the terminal and signals, its timeout
+	 * is the next tick
+	 */
+	int            epfd, sigfd;
+	const struct font_t *font;
+	/* --font auto: 'font' follows the window size */
+	bool_t         autofont;
 	const char     *fontname, *taskname;
 	unsigned int   s_total, s_workd;
+	unsigned int   pauses, s_pausd;
+	enum reason    reason;
 	unsigned short w_height, w_width;
+	struct probes  probes;
+	struct keyring keys;
+	/* as the shell left them, before anything here made them
+	 * non-blocking
+	 */
+	int            stdinfl, stdoutfl;
+	/* why the timer could not go on, told once the journal has the
+	 * session and the terminal is given back
+	 */
+	char           error[256];
+	/* some block could not open the journal, also told once the
+	 * terminal is given back (the alternate screen would wipe it)
+	 */
+	bool_t         unsaved;
+	/* quit, pause, full redraw (resize), show time left, update the
+	 * screen once every pending key has been handled
+	 */
+	bool_t         quit, pause, redraw, left, refresh;
 };
 
-static volatile sig_atomic_t Resize     = FALSE;
-static bool_t                Terminated = FALSE;
+typedef void (*key_handler) (struct front*);
+
+static bool_t Terminated = FALSE;
+
+_Static_assert((KEYS_RING_SIZE & (KEYS_RING_SIZE - 1)) == 0, "the key ring is masked");
+_Static_assert(FONT_FOOTPRINT_GLYPHS == RENDER_CHARSET_SIZE, "font footprints must cover hh:mm:ss");
 
 static inline void get_window_dimensions (unsigned short *w_height, unsigned short *w_width)
 {
@@ -56,119 +116,132 @@ static inline void get_window_dimensions (unsigned short *w_height, unsigned sho
 	*w_width  = (unsigned short) szs.ws_col;
 }
 
-static inline void compute_rendering_origin (struct font_t *font, const unsigned short w_height, const unsigned short w_width, unsigned short *ori_y,  unsigned short *ori_x)
-{
-	*ori_y = (w_height - font->height) >> 1;
-	*ori_x = (w_width  - font->width * RENDER_CHARSET_SIZE) >> 1;
-}
+static void intro_ (struct front*);
+static void outro_ (struct front*);
+
+static void get_signal_set (sigset_t*);
+static bool_t open_events (struct front*);
+static void close_events (struct front*);
 
-enum state
+static const struct font_t *pick_final_font (const char*);
+
+static void run_blocks (const struct plan_entry*, const unsigned int, const char*, struct snapshot_map*);
+static struct plan_entry *read_plan (FILE*, const char*, const char*, const int, unsigned int*);
+static char *trim (char*);
+
+static void main_loop (struct front*);
+static void present (struct front*, const bool_t);
+static void handle_input (struct front*);
+static void key_quit (struct front*);
+static void key_pause (struct front*);
+static void key_extend (struct front*);
+static void key_left (struct front*);
+static void dump_probes (struct front*);
+static void fits_in (struct front*, const unsigned short, const unsigned short);
+
+static const key_handler Keys[256] =
 {
-	state_wkg = 0,
-	state_psd = 1,
+	['q'] = key_quit,
+	[' '] = key_pause,
+	['+'] = key_extend,
+	['L'] = key_left,
 };
 
-/* besides of saying what type of metric is, it also provides
- * the offset at which the value should be rendered
- * hh:mm:ss
- * |  |  ` sixth one
- * |  ` third character to be redered
- * 0 offset
- */
-enum temps
+void frontend_execute (const char *taskname, const char *fontname, const int time, const char *statsout)
 {
-	temps_hur = 0,
-	temps_min = 3,
-	temps_sec = 6,
-};
+	const struct plan_entry single = { .task = taskname, .font = fontname, .time = time };
+	run_blocks(&single, 1, statsout, NULL);
+}
 
-static const char *const States[] =
+void frontend_run_plan (const char *path, const char *fontname, const int time, const char *statsout)
 {
-	"working",
-	"paused "
-};
+	const bool_t fromstdin = !strcmp(path, PLAN_STDIN);
+	FILE *fp = fromstdin ? stdin : fopen(path, "r");
 
-static void intro_ (struct termios*);
-static void outro_ (struct termios*);
+	if (fp == NULL)
+	{
+		fprintf(stderr, "%s: error: cannot open plan '%s'\n", PROGRAM_NAME, path);
+		exit(EXIT_FAILURE);
+	}
 
-static void signal_handler (int);
-static struct font_t pick_final_font (const char*);
+	unsigned int n;
+	struct plan_entry *plan = read_plan(fp, path, fontname, time, &n);
 
-static void main_loop (struct front*);
-static void fits_in (struct front*, const unsigned short, const unsigned short, const bool_t);
+	/* keys are still expected from the terminal */
+	if (fromstdin && !isatty(STDIN_FILENO) && freopen("/dev/tty", "r", stdin) == NULL)
+	{
+		fprintf(stderr, "%s: error: a plan read from stdin needs a controlling terminal\n", PROGRAM_NAME);
+		exit(EXIT_FAILURE);
+	}
+	if (!fromstdin) fclose(fp);
 
-static void render_constant (struct font_t*, const unsigned short, const unsigned, const char*);
-static void render_dynamic (struct font_t*, const unsigned int, const unsigned short, const unsigned short, const enum temps);
+	run_blocks(plan, n, statsout, NULL);
+	free(plan);
+}
 
-void frontend_execute (const char *taskname, const char *fontname, const int time)
+void frontend_resume (const char *statsout)
 {
-	struct front front = {
-		.font     = pick_final_font(fontname),
-		.fontname = fontname,
-		.taskname = taskname,
-		.s_total  = time * 60,
-		.s_workd  = 0
-	};
+	struct snapshot_map map;
+	if (!backend_snapshot_open(&map))
+	{
+		fprintf(stderr, "%s: error: the session snapshot is in use or cannot be opened\n", PROGRAM_NAME);
+		exit(EXIT_FAILURE);
+	}
 
-	intro_(&front.deftty);
-	main_loop(&front);
+	const struct snapshot *snap = map.snap;
+	if (!snap->resumable)
+	{
+		fprintf(stderr, "%s: error: there is no session to resume\n", PROGRAM_NAME);
+		exit(EXIT_FAILURE);
+	}
 
-	if (!Terminated) outro_(&front.deftty);
+	/* names stay within the mapping, nothing rewrites them */
+	const struct plan_entry single = { .task = snap->task, .font = snap->font, .time = (int) (snap->total / 60) };
+	run_blocks(&single, 1, statsout, &map);
 }
 
 void frontend_list_available_fonts (void)
 {
 	printf("%s - list of available fonts\n", PROGRAM_NAME);
-	for (unsigned short i = 0; i < NO_FONTS; i++)
-		printf(" * %s\n", FontNames[i]);
+	for (unsigned short i = 0; i < NoFonts; i++)
+		printf(" * %-12s %2dx%-2d%s\n", FontTable[i].name, FontTable[i].height, FontTable[i].width, strcmp(FontTable[i].name, FONT_DEFAULT) ? "" : " (default)");
+	printf(" * %-12s largest one fitting the window\n", FONT_AUTO);
 }
 
 void frontend_do_preview (const char *fontname)
 {
 	struct front front = { .font = pick_final_font(fontname) };
-	fits_in(&front, FONT_CHARSET_SIZE + 1, 0, FALSE);
-
-	if (Terminated) return;
-
-	for (unsigned short line = 0; line < front.font.height; line++)
-		printf("%*s%s%s%s%s%s%s%s%s%s%s\n\r",
-		front.font.width * 2,
-		front.font.set[ 0][line],
-		front.font.set[ 1][line],
-		front.font.set[ 2][line],
-		front.font.set[ 3][line],
-		front.font.set[ 4][line],
-		front.font.set[ 5][line],
-		front.font.set[ 6][line],
-		front.font.set[ 7][line],
-		front.font.set[ 8][line],
-		front.font.set[ 9][line],
-		front.font.set[10][line]
-		);
+	fits_in(&front, FONT_CHARSET_SIZE + 1, 0);
+
+	if (Terminated) { fputs(front.error, stderr); return; }
+
+	const struct font_t *font = front.font;
+
+	for (unsigned short line = 0; line < font->height; line++)
+	{
+		printf("%*s", font->width, "");
+		for (unsigned short glyph = 0; glyph < FONT_CHARSET_SIZE; glyph++)
+		{
+			const unsigned short len = font_row_len(font, glyph, line);
+			printf("%.*s%*s", len, font_row(font, glyph, line), font->width - len, "");
+		}
+		printf("\n\r");
+	}
 }
 
-static void intro_ (struct termios *deftty)
+static void intro_ (struct front *front)
 {
-	/* Signal hanlder
+	/* Signals
 	 * All brute force methods to exit
 	 * the program will be ignore (as
 	 * long as it is possible), the only
 	 * signal the program will handle is
-	 * when the terminal gets resized
+	 * when the terminal gets resized. All
+	 * of them are blocked and delivered
+	 * through the signalfd in main_loop
 	 */
-	struct sigaction s;
-	s.sa_handler = signal_handler;
-	sigemptyset(&s.sa_mask);
-
-	sigaction(SIGWINCH, &s, NULL);
-
 	sigset_t block;
-	sigemptyset(&block);
-
-	sigaddset(&block, SIGTSTP);
-	sigaddset(&block, SIGINT);
-	sigaddset(&block, SIGQUIT);
-	sigaddset(&block, SIGHUP);
+	get_signal_set(&block);
 	sigprocmask(SIG_BLOCK, &block, NULL);
 
 	/* Terminal configuration
@@ -177,8 +250,8 @@ static void intro_ (struct termios *deftty)
 	 *  - no displaying characters & provide chars as they're typed
 	 *  - only read one characters to be read
 	 */
-	tcgetattr(STDIN_FILENO, deftty);
-	struct termios custty = *deftty;
+	tcgetattr(STDIN_FILENO, &front->deftty);
+	struct termios custty = front->deftty;
 
 	custty.c_iflag &= ~(IXON | IXOFF);
 	custty.c_oflag &= ~(OPOST);
@@ -187,154 +260,488 @@ static void intro_ (struct termios *deftty)
 
 	tcsetattr(STDIN_FILENO, TCSANOW, &custty);
 
+	/* stdin and stdout usually share one open file description, so
+	 * once either is made non-blocking the other one is as well
+	 */
+	front->stdinfl  = fcntl(STDIN_FILENO, F_GETFL);
+	front->stdoutfl = fcntl(STDOUT_FILENO, F_GETFL);
+
 	printf(INTRO_ANSI);
 	fflush(stdout);
 }
 
-static void outro_ (struct termios *deftty)
+static void outro_ (struct front *front)
 {
-	tcsetattr(STDIN_FILENO, TCSANOW, deftty);
+	/* stdio cannot cope with EAGAIN, blocking comes first */
+	if (front->stdinfl  != -1) fcntl(STDIN_FILENO, F_SETFL, front->stdinfl);
+	if (front->stdoutfl != -1) fcntl(STDOUT_FILENO, F_SETFL, front->stdoutfl);
+
+	tcsetattr(STDIN_FILENO, TCSANOW, &front->deftty);
 	printf(OUTRO_ANSI);
 	fflush(stdout);
 }
 
-static void signal_handler (int s)
+static void get_signal_set (sigset_t *set)
+{
+	sigemptyset(set);
+
+	sigaddset(set, SIGWINCH);
+	sigaddset(set, SIGTSTP);
+	sigaddset(set, SIGINT);
+	sigaddset(set, SIGQUIT);
+	sigaddset(set, SIGHUP);
+	sigaddset(set, SIGUSR1);
+}
+
+static bool_t open_events (struct front *front)
+{
+	sigset_t set;
+	get_signal_set(&set);
+
+	front->sigfd = signalfd(-1, &set, SFD_NONBLOCK | SFD_CLOEXEC);
+	front->epfd  = epoll_create1(EPOLL_CLOEXEC);
+
+	if (front->sigfd == -1 || front->epfd == -1) return FALSE;
+
+	/* keys are drained until EAGAIN, outro_ gives the flags back */
+	if (front->stdinfl == -1 || fcntl(STDIN_FILENO, F_SETFL, front->stdinfl | O_NONBLOCK) == -1) return FALSE;
+
+	const int fds[] = { STDIN_FILENO, front->sigfd };
+	for (unsigned short i = 0; i < sizeof(fds) / sizeof(fds[0]); i++)
+	{
+		struct epoll_event ev = { .events = EPOLLIN, .data.fd = fds[i] };
+		if (epoll_ctl(front->epfd, EPOLL_CTL_ADD, fds[i], &ev) == -1) return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void close_events (struct front *front)
 {
-	(void) s;
-	Resize = TRUE;
+	if (front->sigfd != -1) close(front->sigfd);
+	if (front->epfd  != -1) close(front->epfd);
 }
 
-static struct font_t pick_final_font (const char *name)
+static const struct font_t *pick_final_font (const char *name)
 {
 	/* since 'given' is a string given via argv, it is assumed to be
 	 * null-byte terminated, therefore we do not need to worry about
 	 * variable lengths
 	 */
-	     if (!strcmp(name, "bulbhead"))   { return f_bulbhead;   }
-	else if (!strcmp(name, "braced"))     { return f_braced;     }
-	else if (!strcmp(name, "fraktur"))    { return f_fraktur;    }
-	else if (!strcmp(name, "hollywood"))  { return f_hollywood;  }
-	else if (!strcmp(name, "larry3d"))    { return f_larry3d;    }
-	else if (!strcmp(name, "raw"))        { return f_raw;        }
-	else if (!strcmp(name, "rectangles")) { return f_rectangles; }
-	else if (!strcmp(name, "short"))      { return f_short;      }
-	else
+	const struct font_t *font = font_lookup(name);
+	if (font) return font;
+
+	/* not a built-in one, maybe a path to a FIGlet font */
+	if ((font = font_load_flf(name))) return font;
+
+	static const char *const errmsg =
+	"%s: error: '%s' is not defined as a font nor is a FIGlet (.flf) font file\n"
+	" make sure it exists by checking all available fonts\n"
+	" $ %s --list\n";
+	fprintf(stderr, errmsg, PROGRAM_NAME, name, PROGRAM_NAME);
+	exit(EXIT_FAILURE);
+}
+
+static void run_blocks (const struct plan_entry *plan, const unsigned int n, const char *statsout, struct snapshot_map *resume)
+{
+	/* fonts are picked (and possibly loaded) before the terminal is
+	 * taken, a wrong one is reported on a sane screen
+	 */
+	const struct font_t **fonts = (const struct font_t**) malloc(n * sizeof(*fonts));
+	if (fonts == NULL)
 	{
-		static const char *const errmsg =
-		"%s: error: '%s' is not defined as a font\n"
-		" make sure it exists by checking all available fonts\n"
-		" $ %s --list\n";
-		fprintf(stderr, errmsg, PROGRAM_NAME, name, PROGRAM_NAME);
+		fprintf(stderr, "%s: error: out of memory\n", PROGRAM_NAME);
 		exit(EXIT_FAILURE);
 	}
+	for (unsigned int i = 0; i < n; i++)
+	{
+		fonts[i] = strcmp(plan[i].font, FONT_AUTO) ? pick_final_font(plan[i].font) : NULL;
+	}
+
+	struct front front = {
+		.epfd     = -1,
+		.sigfd    = -1,
+		.stdinfl  = -1,
+		.stdoutfl = -1,
+		.probes   = {
+			.late    = { .name = "tick lateness", .unit = "ns"    },
+			.path    = statsout
+		}
+	};
+
+	/* whoever holds the snapshot already (another 4T) keeps it */
+	struct snapshot_map own, *map = resume ? resume : &own;
+	if (!resume && !backend_snapshot_open(&own))
+	{
+		fprintf(stderr, "%s: warning: cannot take the session snapshot (in use or unwritable), this session cannot be resumed\n", PROGRAM_NAME);
+	}
+	if (!status_open(&front.status))
+	{
+		fprintf(stderr, "%s: warning: cannot publish the status under '%s'\n", PROGRAM_NAME, STATUS_DIR);
+	}
+
+	intro_(&front);
+
+	/* the terminal, the event set, the timer and the screen thread
+	 * are set up once and shared by every block
+	 */
+	if (!open_events(&front) || !screen_start(&front.screen, STDOUT_FILENO))
+	{
+		snprintf(front.error, sizeof(front.error), "%s: error: cannot set up the event loop\n", PROGRAM_NAME);
+		Terminated = TRUE;
+	}
+
+	for (unsigned int i = 0; i < n && !Terminated; i++)
+	{
+		front.font     = fonts[i] ? fonts[i] : font_smallest()->font;
+		front.autofont = fonts[i] == NULL;
+		front.fontname = plan[i].font;
+		front.taskname = plan[i].task;
+		front.s_total  = plan[i].time * 60;
+		front.s_workd  = front.pauses = front.s_pausd = 0;
+
+		bool_t opened;
+		if (resume && i == 0)
+		{
+			front.s_total = map->snap->total;
+			front.s_workd = map->snap->worked;
+			front.pauses  = map->snap->pauses;
+			front.s_pausd = map->snap->paused;
+			opened = backend_resume(&front.journal, map->snap);
+		}
+		else { opened = backend_open(&front.journal, front.taskname, front.fontname, front.s_total, map->snap); }
+
+		if (!opened) front.unsaved = TRUE;
+
+		main_loop(&front);
+
+		backend_record(&front.journal, front.reason, front.s_workd, front.pauses, front.s_pausd);
+		backend_close(&front.journal);
+
+		/* only a finished block moves on to the next one */
+		if (front.reason != reason_done) break;
+	}
+
+	/* the last frame is out before the terminal is given back */
+	screen_stop(&front.screen);
+	close_events(&front);
+	backend_snapshot_close(map);
+	status_close(&front.status);
+
+	outro_(&front);
+	if (front.unsaved) fprintf(stderr, "%s: warning: cannot open journal '%s', progress was not saved\n", PROGRAM_NAME, backend_journal_path());
+	if (Terminated) fputs(front.error, stderr);
+
+	dump_probes(&front);
+	free(fonts);
 }
 
-static void main_loop (struct front *front)
+static struct plan_entry *read_plan (FILE *fp, const char *path, const char *fontname, const int time, unsigned int *n)
 {
-	bool_t quit = FALSE, pause = FALSE, render_1 = TRUE;
+	struct plan_entry *plan = NULL;
+	unsigned int cap = 0, lineno = 0;
+	char *line = NULL;
+	size_t size = 0;
+
+	*n = 0;
+
+	/* every line is kept as it is, entries point into them */
+	while (getline(&line, &size, fp) != -1)
+	{
+		lineno++;
+
+		char *comment = strchr(line, PLAN_COMMENT);
+		if (comment) *comment = 0;
+
+		char *fields[3] = { line, NULL, NULL };
+		for (unsigned short f = 1; f < 3; f++)
+		{
+			if (!fields[f - 1] || !(fields[f] = strchr(fields[f - 1], PLAN_SEPARATOR))) break;
+			*fields[f]++ = 0;
+		}
+
+		const char *task = trim(fields[0]);
+		if (*task == 0 && !fields[1]) continue;
+
+		const char *mins = fields[1] ? trim(fields[1]) : "";
+		const char *font = fields[2] ? trim(fields[2]) : "";
+		char *end;
+		const long minutes = *mins ? strtol(mins, &end, 10) : time;
 
-	struct timeval tv;
-	fd_set inset;
+		if (*task == 0 || (*mins && (*end || minutes <= 0)))
+		{
+			fprintf(stderr, "%s: error: %s:%u: expected 'task, minutes, font'\n", PROGRAM_NAME, path, lineno);
+			exit(EXIT_FAILURE);
+		}
 
-	unsigned short ori_y, ori_x;
-	enum state state = state_wkg;
+		if (*n == cap)
+		{
+			cap  = cap ? cap * 2 : 16;
+			plan = (struct plan_entry*) realloc(plan, cap * sizeof(*plan));
+			if (plan == NULL)
+			{
+				fprintf(stderr, "%s: error: out of memory\n", PROGRAM_NAME);
+				exit(EXIT_FAILURE);
+			}
+		}
 
-	while (!quit && !Terminated)
+		plan[(*n)++] = (struct plan_entry) { .task = task, .font = *font ? font : fontname, .time = (int) minutes };
+		line = NULL;
+		size = 0;
+	}
+
+	free(line);
+
+	if (*n == 0)
 	{
-		tv.tv_sec  = 1 - render_1;
-		tv.tv_usec = 0;
+		fprintf(stderr, "%s: error: plan '%s' has no blocks\n", PROGRAM_NAME, path);
+		exit(EXIT_FAILURE);
+	}
+	return plan;
+}
+
+static char *trim (char *str)
+{
+	while (isspace((unsigned char) *str)) str++;
+
+	char *end = str + strlen(str);
+	while (end > str && isspace((unsigned char) end[-1])) end--;
+
+	*end = 0;
+	return str;
+}
+
+static void main_loop (struct front *front)
+{
+	unsigned int checkpoint = 0;
 
-		FD_ZERO(&inset);
-		FD_SET(STDIN_FILENO, &inset);
+	front->reason = reason_quit;
+	front->quit   = front->pause = FALSE;
+	front->redraw = TRUE;
 
-		const int ret = select(STDIN_FILENO + 1, &inset, NULL, NULL, &tv);
-		if ((ret == -1 && Resize) || render_1)
+	tick_start(&front->tick, NS_PER_SEC, front->s_workd);
+
+	/* a resumed session goes on from where it was */
+	checkpoint = front->s_workd;
+	front->tick.paused = (int64_t) front->s_pausd * NS_PER_SEC;
+
+	while (!front->quit && !Terminated)
+	{
+		if (front->redraw)
 		{
-			printf("\x1b[2J");
+			fits_in(front, RENDER_CHARSET_SIZE, EXTRA_RENDERED_LINES);
+			if (Terminated == TRUE) { front->reason = reason_small; break; }
 
-			fits_in(front, RENDER_CHARSET_SIZE, EXTRA_RENDERED_LINES, TRUE);
-			if (Terminated == TRUE) break;
+			present(front, TRUE);
+			front->redraw = FALSE;
+		}
+
+		/* the timeout only tells when to look at the clock again
+		 * (it may end a little late, see TICK_SLACK_SHIFT), the
+		 * time spent here has nothing to do with the time measured
+		 */
+		struct epoll_event evs[2];
+		const int n = epoll_wait(front->epfd, evs, 2, tick_timeout(&front->tick));
 
-			compute_rendering_origin(&front->font, front->w_height, front->w_width, &ori_y, &ori_x);
-			render_constant(&front->font, ori_y, ori_x, front->taskname);
+		for (int i = 0; i < n; i++)
+		{
+			const int fd = evs[i].data.fd;
 
-			Resize   = FALSE;
-			render_1 = FALSE;
-			continue;
+			if (fd == STDIN_FILENO) handle_input(front);
+			else if (fd == front->sigfd)
+			{
+				/* several resizes in a row end up in a single redraw */
+				struct signalfd_siginfo si;
+				while (read(front->sigfd, &si, sizeof(si)) == sizeof(si))
+				{
+					if (si.ssi_signo == SIGWINCH) front->redraw = TRUE;
+					if (si.ssi_signo == SIGHUP)   { front->quit = TRUE; front->reason = reason_hangup; }
+					if (si.ssi_signo == SIGUSR1)  dump_probes(front);
+				}
+			}
 		}
 
-		if (FD_ISSET(STDIN_FILENO, &inset))
+		if (tick_consume(&front->tick))
 		{
-			switch (fgetc(stdin))
+			hist_record(&front->probes.late, front->tick.late);
+			front->s_workd = (unsigned int) ((front->tick.deadline - front->tick.origin) / NS_PER_SEC);
+			backend_snapshot_update(front->journal.snap, front->s_workd, front->pauses, front->s_pausd);
+
+			/* only hands the record to the journal's batch,
+			 * nothing here waits for the disk
+			 */
+			if (front->s_workd - checkpoint >= CHECKPOINT_EVERY)
 			{
-				case 'q': quit  = TRUE; break;
-				case ' ': pause = !pause; state = 1 - state; break;
-				case '+': break;
-				case 'L': break;
+				checkpoint = front->s_workd;
+				backend_record(&front->journal, reason_checkpoint, front->s_workd, front->pauses, front->s_pausd);
 			}
 
-			continue;
+			front->refresh = TRUE;
 		}
 
-		render_dynamic(&front->font, front->s_workd, ori_y, ori_x, temps_sec);
-		if (front->s_workd++ == front->s_total) break;
+		/* keys and ticks of this wakeup end up in a single frame */
+		if (front->refresh && !front->redraw) present(front, FALSE);
+		front->refresh = FALSE;
+
+		if (front->s_workd >= front->s_total) { front->reason = reason_done; break; }
+	}
+
+	/* a pause still going on is part of the session as well */
+	if (front->pause)
+	{
+		tick_resume(&front->tick);
+		front->s_pausd = (unsigned int) (front->tick.paused / NS_PER_SEC);
 	}
 }
 
-static void fits_in (struct front* front, const unsigned short setsz, const unsigned short plsrws, const bool_t timerunning)
+static void present (struct front *front, const bool_t layout)
 {
-	get_window_dimensions(&front->w_height, &front->w_width);
+	/* time left never goes below zero, '+' may come late */
+	const unsigned int left = front->s_total > front->s_workd ? front->s_total - front->s_workd : 0;
 
-	const unsigned short w_needed = front->font.width  * setsz;
-	const unsigned short h_needed = front->font.height + plsrws;
+	if (layout) front->layout++;
 
-	if (w_needed < front->w_width && h_needed < front->w_height) return;
+	/* handed over as is, the screen thread does the drawing and
+	 * the writing, nothing here can wait on the terminal
+	 */
+	const struct view view =
+	{
+		.font   = front->font,
+		.task   = front->taskname,
+		.secs   = front->left ? left : front->s_workd,
+		.state  = front->pause ? state_psd : state_wkg,
+		.height = front->w_height,
+		.width  = front->w_width,
+		.layout = front->layout
+	};
+	screen_publish(&front->screen, &view);
 
-	static const char *const errmsg =
-	"%s:error: cannot continue since the dimensions are too small\n"
-	" minimum dimensions: %d rows by %d columns\n"
-	" current dimensions: %d rows by %d columns\n"
-	" all progress (if any) will be saved!\n";
+	/* every change of the state ends up here, so does the status */
+	status_publish(&front->status, front->taskname, front->pause ? status_paused : status_working, front->s_workd, front->s_total);
+}
 
-	if (timerunning) { outro_(&front->deftty); }
+static void handle_input (struct front *front)
+{
+	struct keyring *ring = &front->keys;
+	bool_t full;
 
-	fprintf(stderr, errmsg, PROGRAM_NAME, w_needed, h_needed, front->w_height, front->w_width);
-	fflush(stderr);
+	do
+	{
+		/* everything the terminal has got so far, straight from
+		 * the fd so no key is left behind in a stdio buffer
+		 */
+		while (ring->head - ring->tail < KEYS_RING_SIZE)
+		{
+			const unsigned int at   = ring->head & (KEYS_RING_SIZE - 1);
+			const unsigned int free = KEYS_RING_SIZE - (ring->head - ring->tail);
+			const unsigned int room = KEYS_RING_SIZE - at < free ? KEYS_RING_SIZE - at : free;
 
-	Terminated = TRUE;
+			const ssize_t n = read(STDIN_FILENO, ring->bytes + at, room);
+			if (n > 0) { ring->head += (unsigned int) n; continue; }
+
+			if (n == -1 && errno == EINTR) continue;
+			/* the terminal is gone, as good as a hangup */
+			if (n == 0) { front->quit = TRUE; front->reason = reason_hangup; }
+			break;
+		}
+
+		full = ring->head - ring->tail == KEYS_RING_SIZE;
+
+		while (ring->tail != ring->head)
+		{
+			const unsigned char key = ring->bytes[ring->tail++ & (KEYS_RING_SIZE - 1)];
+			if (Keys[key]) Keys[key](front);
+		}
+	} while (full);
+}
+
+static void key_quit (struct front *front)
+{
+	front->quit = TRUE;
 }
 
-static void render_constant (struct font_t *font, const unsigned short ori_y, const unsigned ori_x, const char *task)
+static void key_pause (struct front *front)
 {
-	const unsigned short coffset[] =
+	/* a paused timer has nothing to show but its state, hence the
+	 * ticks are stopped altogether rather than ignored
+	 */
+	front->pause = !front->pause;
+	if (front->pause) { tick_pause(&front->tick); front->pauses++; }
+	else
 	{
-		font->width * 2,
-		font->width * 5,
-	};
+		tick_resume(&front->tick);
+		front->s_pausd = (unsigned int) (front->tick.paused / NS_PER_SEC);
+	}
+	backend_snapshot_update(front->journal.snap, front->s_workd, front->pauses, front->s_pausd);
+	front->refresh = TRUE;
+}
 
-	for (unsigned short i = 0; i < 2; i++)
-		for (unsigned short line = 0; line < font->height; line++)
-			printf("\x1b[5m\x1b[%d;%dH%s\x1b[0m", ori_y + line, ori_x + coffset[i], font->set[COLON_INDEX][line]);
+static void key_extend (struct front *front)
+{
+	front->s_total += EXTEND_BY;
+	backend_set_total(&front->journal, front->s_total);
+	front->refresh = TRUE;
+}
 
-	const unsigned short loffset = ori_y + font->height + 2;
-	
-	printf("\x1b[%d;%dHworking on \x1b[1m%s\x1b[0m",            loffset + 0, ori_x, task);
-	printf("\x1b[%d;%dH\x1b[2mpress 'q' to save & quit\x1b[0m", loffset + 1, ori_x);
-	printf("\x1b[%d;%dHstate: %s",                              loffset + 2, ori_x, States[state_wkg]);
+static void key_left (struct front *front)
+{
+	front->left    = !front->left;
+	front->refresh = TRUE;
+}
 
-	fflush(stdout);
+static void dump_probes (struct front *front)
+{
+	const struct probes *probes = &front->probes;
+	if (probes->path == NULL) return;
+
+	struct screen_probes screen;
+	screen_read_probes(&front->screen, &screen);
+
+	FILE *fp = fopen(probes->path, "w");
+	if (fp == NULL)
+	{
+		fprintf(stderr, "%s: warning: cannot write stats to '%s'\n", PROGRAM_NAME, probes->path);
+		return;
+	}
+
+	hist_dump(&probes->late, fp);
+	hist_dump(&screen.render, fp);
+	hist_dump(&screen.written, fp);
+	hist_dump(&screen.blocked, fp);
+	fprintf(fp, "dropped frames: %llu\n", (unsigned long long) screen.dropped);
+	fclose(fp);
 }
 
-static void render_dynamic (struct font_t *font, const unsigned int val, const unsigned short ori_y, const unsigned short ori_x, const enum temps temps)
+static void fits_in (struct front* front, const unsigned short setsz, const unsigned short plsrws)
 {
-	const unsigned short idxs[] = { (unsigned short) val / 10, (unsigned short) val % 10};
-	const unsigned short offs[] = { ori_x + temps * font->width, ori_x + (temps + 1) * font->width };
+	get_window_dimensions(&front->w_height, &front->w_width);
 
-	for (unsigned short line = 0; line < font->height; line++)
-		printf("\x1b[%d;%dH%s\x1b[%d;%dH%s",
-		ori_y + line, offs[0], font->set[idxs[0]][line],
-		ori_y + line, offs[1], font->set[idxs[1]][line]
-		);
+	/* the footprints already are FONT_FOOTPRINT_GLYPHS wide, stepping
+	 * down to a smaller font is only a scan over them, and the
+	 * smallest one tells what is missing when not even that fits
+	 */
+	if (front->autofont)
+	{
+		const int rows = front->w_height - plsrws - 1, cols = front->w_width - 1;
+		const struct font_entry *fit = (rows > 0 && cols > 0) ? font_fitting(rows, cols) : NULL;
 
-	fflush(stdout);
+		front->font = fit ? fit->font : font_smallest()->font;
+	}
+
+	const unsigned short w_needed = front->font->width  * setsz;
+	const unsigned short h_needed = front->font->height + plsrws;
+
+	if (w_needed < front->w_width && h_needed < front->w_height) return;
+
+	static const char *const errmsg =
+	"%s:error: cannot continue since the dimensions are too small\n"
+	" minimum dimensions: %d rows by %d columns\n"
+	" current dimensions: %d rows by %d columns\n"
+	" all progress (if any) will be saved!\n";
+
+	/* a running timer still has to save the session and give the
+	 * terminal back before anyone can read this
+	 */
+	snprintf(front->error, sizeof(front->error), errmsg, PROGRAM_NAME, h_needed, w_needed, front->w_height, front->w_width);
+	Terminated = TRUE;
 }
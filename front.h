@@ -1,7 +1,18 @@
 #ifndef FT_FRONT_H
 #define FT_FRONT_H
 
-void frontend_execute (const char*, const char*, const int);
+/* One block of a plan, they run back to back within the very same
+ * terminal session
+ */
+struct plan_entry
+{
+	const char *task, *font;
+	int        time;
+};
+
+void frontend_execute (const char*, const char*, const int, const char*);
+void frontend_run_plan (const char*, const char*, const int, const char*);
+void frontend_resume (const char*);
 void frontend_list_available_fonts (void);
 
 void frontend_do_preview (const char*);
@@ -0,0 +1,51 @@
+#include "hist.h"
+
+static inline uint64_t lowest (const unsigned int i)
+{
+	if (i < HIST_SUB) return i;
+
+	const unsigned int shift = i / HIST_SUB - 1;
+	return (uint64_t) (HIST_SUB + i % HIST_SUB) << shift;
+}
+
+static inline uint64_t highest (const unsigned int i)
+{
+	return i + 1 < HIST_BUCKETS ? lowest(i + 1) - 1 : UINT64_MAX;
+}
+
+uint64_t hist_value_at (const struct hist *h, const double q)
+{
+	if (h->count == 0) return 0;
+
+	/* rank of the wanted sample, the bucket's upper edge is reported
+	 * (never above the real maximum) so quantiles are not understated
+	 */
+	const uint64_t rank = (uint64_t) (q * (double) (h->count - 1)) + 1;
+	uint64_t seen = 0;
+
+	for (unsigned int i = 0; i < HIST_BUCKETS; i++)
+	{
+		seen += h->buckets[i];
+		if (seen >= rank) return highest(i) < h->max ? highest(i) : h->max;
+	}
+
+	return h->max;
+}
+
+void hist_dump (const struct hist *h, FILE *fp)
+{
+	fprintf(fp, "%s (%s): count %llu mean %llu p50 %llu p90 %llu p99 %llu p99.9 %llu max %llu\n", h->name, h->unit,
+	        (unsigned long long) h->count,
+	        (unsigned long long) (h->count ? h->sum / h->count : 0),
+	        (unsigned long long) hist_value_at(h, 0.50),
+	        (unsigned long long) hist_value_at(h, 0.90),
+	        (unsigned long long) hist_value_at(h, 0.99),
+	        (unsigned long long) hist_value_at(h, 0.999),
+	        (unsigned long long) h->max);
+
+	for (unsigned int i = 0; i < HIST_BUCKETS; i++)
+	{
+		if (h->buckets[i] == 0) continue;
+		fprintf(fp, "  [%llu, %llu] %u\n", (unsigned long long) lowest(i), (unsigned long long) highest(i), h->buckets[i]);
+	}
+}
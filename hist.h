@@ -0,0 +1,45 @@
+#ifndef FT_HIST_H
+#define FT_HIST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Log-linear histogram (HDR style): values below HIST_SUB get a bucket
+ * each, above that every power of two is split into HIST_SUB buckets,
+ * so the relative error stays under 1/HIST_SUB for any magnitude.
+ * Everything is preallocated, recording is a couple of instructions
+ */
+#define HIST_SUB_BITS      3
+#define HIST_SUB           (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS       ((64 - HIST_SUB_BITS + 1) * HIST_SUB)
+
+struct hist
+{
+	const char *name, *unit;
+	uint64_t   count, sum, max;
+	uint32_t   buckets[HIST_BUCKETS];
+};
+
+static inline unsigned int hist_index (const uint64_t v)
+{
+	if (v < HIST_SUB) return (unsigned int) v;
+
+	const unsigned int shift = 63 - __builtin_clzll(v) - HIST_SUB_BITS;
+	return (shift + 1) * HIST_SUB + (unsigned int) ((v >> shift) & (HIST_SUB - 1));
+}
+
+static inline void hist_record (struct hist *h, const int64_t v)
+{
+	/* early wakeups and the like count as zero */
+	const uint64_t u = v > 0 ? (uint64_t) v : 0;
+
+	h->buckets[hist_index(u)]++;
+	h->count++;
+	h->sum += u;
+	if (u > h->max) h->max = u;
+}
+
+uint64_t hist_value_at (const struct hist*, const double);
+void hist_dump (const struct hist*, FILE*);
+
+#endif
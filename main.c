@@ -1,32 +1,44 @@
 #include "cxa.h"
+#include "back.h"
 #include "front.h"
+#include "daemon.h"
+#include "status.h"
 #include "common.h"
+#include "flagset.h"
 
 #include <stdio.h>
 #include <string.h>
 
 #define FLAG_TASK_DESC "task name (mandatory)"
-#define FLAG_FONT_DESC "font (default: short)"
+#define FLAG_FONT_DESC "font, 'auto' fits the window (default: short)"
 #define FLAG_TIME_DESC "work time in mins (default: 30)"
 #define FLAG_LIST_DESC "list all available fonts"
 #define FLAG_PREV_DESC "do preview of <fontname> font"
+#define FLAG_STAT_DESC "worked time per task/day/week (of <task>)"
+#define FLAG_DAEM_DESC "host every timer within a background daemon"
+#define FLAG_CTRL_DESC "send <command> to the daemon (see daemon.h)"
+#define FLAG_SOUT_DESC "dump timing histograms to <file> (also on SIGUSR1)"
+#define FLAG_RSME_DESC "go on with the last unfinished session"
+#define FLAG_STUS_DESC "print running timers, [format]: %t %s %w %l %T %p"
+#define FLAG_PLAN_DESC "run every 'task, mins, font' line of <file> (- for stdin)"
 
 #define FLAG_FONT_DEFT "short"
 #define FLAG_TIME_DEFT 30
 #define FLAG_TASK_DEFT ""
 
-#define PROGRAM_USAGE  "4T --task <taskname> [flags]"
+#define PROGRAM_USAGE  "4T --task <taskname> [flags] | 4T --plan <file> [flags]"
 
 struct program
 {
 	struct
 	{
-		char *task, *font;
+		char *task, *font, *stats, *ctl, *statsout, *plan, *status;
 		int  time;
 	} args;
 };
 
 static void set_default_flags (struct program*);
+static int dispatch (struct program*, const struct CxaFlag*);
 
 int main (int argc, char **argv)
 {
@@ -35,20 +47,65 @@ int main (int argc, char **argv)
 
 	struct CxaFlag flags[] =
 	{
-		CXA_SET_STR("task", FLAG_TASK_DESC, &prg.args.task, CXA_FLAG_TAKER_YES, 't'),
-		CXA_SET_STR("font", FLAG_FONT_DESC, &prg.args.font, CXA_FLAG_TAKER_YES, 'f'),
-		CXA_SET_STR("time", FLAG_TIME_DESC, &prg.args.time, CXA_FLAG_TAKER_YES, 'T'),
-		CXA_SET_CHR("list", FLAG_LIST_DESC, NULL,           CXA_FLAG_TAKER_NON, 'L'),
-		CXA_SET_STR("prev", FLAG_PREV_DESC, &prg.args.font, CXA_FLAG_TAKER_YES, 'p'),
+		CXA_SET_STR("task",   FLAG_TASK_DESC, &prg.args.task,  CXA_FLAG_TAKER_YES, 't'),
+		CXA_SET_STR("font",   FLAG_FONT_DESC, &prg.args.font,  CXA_FLAG_TAKER_YES, 'f'),
+		CXA_SET_INT("time",   FLAG_TIME_DESC, &prg.args.time,  CXA_FLAG_TAKER_YES, 'T'),
+		CXA_SET_CHR("list",   FLAG_LIST_DESC, NULL,            CXA_FLAG_TAKER_NON, 'L'),
+		CXA_SET_STR("prev",   FLAG_PREV_DESC, &prg.args.font,  CXA_FLAG_TAKER_YES, 'p'),
+		CXA_SET_STR("stats",  FLAG_STAT_DESC, &prg.args.stats, CXA_FLAG_TAKER_MAY, 's'),
+		CXA_SET_CHR("daemon", FLAG_DAEM_DESC, NULL,            CXA_FLAG_TAKER_NON, 'D'),
+		CXA_SET_STR("ctl",    FLAG_CTRL_DESC, &prg.args.ctl,   CXA_FLAG_TAKER_YES, 'c'),
+		CXA_SET_STR("stats-out", FLAG_SOUT_DESC, &prg.args.statsout, CXA_FLAG_TAKER_YES, 'o'),
+		CXA_SET_STR("plan",   FLAG_PLAN_DESC, &prg.args.plan,  CXA_FLAG_TAKER_YES, 'P'),
+		CXA_SET_CHR("resume", FLAG_RSME_DESC, NULL,            CXA_FLAG_TAKER_NON, 'r'),
+		CXA_SET_STR("status", FLAG_STUS_DESC, &prg.args.status, CXA_FLAG_TAKER_MAY, 'S'),
 
 		CXA_SET_END
 	};
 
-	cxa_clean(cxa_execute((unsigned char) argc, argv, flags, PROGRAM_NAME));
+	/* flagset.h must be regenerated (make flagset) whenever flags change */
+	_Static_assert(sizeof(flags) / sizeof(flags[0]) == FLAGS_COUNT + 1, "flagset.h is out of date");
+
+	/* string arguments coming from response files point straight into
+	 * their mappings, which are gone once the parse is cleaned up
+	 */
+	struct Cxa *cxa = cxa_execute_hashed(argc, argv, flags, &FlagHash, PROGRAM_NAME);
+	const int status = dispatch(&prg, flags);
+
+	cxa_clean(cxa);
+	return status;
+}
+
+static int dispatch (struct program *prg, const struct CxaFlag *flags)
+{
+	/* meant to be run every second by status bars, nothing but the
+	 * status pages is touched (no terminal, no fonts, no journal)
+	 */
+	if (flags[11].meta & CXA_FLAG_SEEN_MASK)
+	{
+		return status_query(prg->args.status);
+	}
 
 	if (flags[4].meta & CXA_FLAG_SEEN_MASK)
 	{
-		frontend_do_preview(prg.args.font);
+		frontend_do_preview(prg->args.font);
+		return 0;
+	}
+
+	if (flags[6].meta & CXA_FLAG_SEEN_MASK)
+	{
+		daemon_run();
+		return 0;
+	}
+
+	if (flags[7].meta & CXA_FLAG_SEEN_MASK)
+	{
+		return daemon_command(prg->args.ctl);
+	}
+
+	if (flags[5].meta & CXA_FLAG_SEEN_MASK)
+	{
+		backend_print_stats(prg->args.stats);
 		return 0;
 	}
 
@@ -58,13 +115,25 @@ int main (int argc, char **argv)
 		return 0;
 	}
 
-	if ((*prg.args.task == 0) || !(flags[0].meta & CXA_FLAG_SEEN_MASK))
+	if (flags[10].meta & CXA_FLAG_SEEN_MASK)
+	{
+		frontend_resume(prg->args.statsout);
+		return 0;
+	}
+
+	if (flags[9].meta & CXA_FLAG_SEEN_MASK)
+	{
+		frontend_run_plan(prg->args.plan, prg->args.font, prg->args.time, prg->args.statsout);
+		return 0;
+	}
+
+	if ((*prg->args.task == 0) || !(flags[0].meta & CXA_FLAG_SEEN_MASK))
 	{
 		cxa_print_usage(PROGRAM_USAGE, flags);	
 		return 0;
 	}
 	
-	frontend_execute(prg.args.task, prg.args.font, prg.args.time);
+	frontend_execute(prg->args.task, prg->args.font, prg->args.time, prg->args.statsout);
 	return 0;
 }
 
@@ -74,4 +143,6 @@ static void set_default_flags (struct program *prg)
 	prg->args.font = FLAG_FONT_DEFT;
 	prg->args.time = FLAG_TIME_DEFT;
 	prg->args.task = FLAG_TASK_DEFT;
+	prg->args.stats = NULL;
+	prg->args.status = STATUS_FORMAT;
 }
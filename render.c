@@ -0,0 +1,210 @@
+#include "render.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* value after which every digit wraps around and the slot it is drawn at */
+static const unsigned char DigitMax[CLOCK_DIGITS]  = { 9, 9, 5, 9, 5, 9 };
+static const unsigned char DigitSlot[CLOCK_DIGITS] =
+{
+	temps_hur, temps_hur + 1,
+	temps_min, temps_min + 1,
+	temps_sec, temps_sec + 1
+};
+
+static const char *const States[] =
+{
+	"working",
+	"paused "
+};
+
+static void render_constant (struct frame*, const struct font_t*, const unsigned short, const unsigned, const char*);
+static void put_state (struct frame*, const struct font_t*, const unsigned short, const unsigned short, const enum state);
+static void clock_set (struct clock*, const unsigned int);
+static void clock_advance (struct clock*);
+static void clock_retreat (struct clock*);
+
+static void build_glyph_cache (struct glyph_cache*, const struct font_t*, const unsigned short, const unsigned short);
+static void draw_glyph (struct frame*, struct glyph_cache*, const unsigned short, const unsigned short);
+static void put_glyph_row (struct frame*, const unsigned short, const unsigned short, const struct font_t*, const unsigned short, const unsigned short, const unsigned char);
+
+static inline void compute_rendering_origin (const struct font_t *font, const unsigned short w_height, const unsigned short w_width, unsigned short *ori_y,  unsigned short *ori_x)
+{
+	*ori_y = (w_height - font->height) >> 1;
+	*ori_x = (w_width  - font->width * RENDER_CHARSET_SIZE) >> 1;
+}
+
+void render_layout (struct render *r, const unsigned short w_height, const unsigned short w_width)
+{
+	/* the whole frame is composed again off-screen, the
+	 * screen clearing travels within the same write
+	 */
+	frame_resize(&r->frame, w_height, w_width);
+	compute_rendering_origin(r->font, w_height, w_width, &r->ori_y, &r->ori_x);
+	build_glyph_cache(&r->glyphs, r->font, r->ori_y, r->ori_x);
+
+	render_constant(&r->frame, r->font, r->ori_y, r->ori_x, r->task);
+	put_state(&r->frame, r->font, r->ori_y, r->ori_x, r->state);
+
+	/* nothing of the clock is on the new screen yet */
+	r->clock.dirty = CLOCK_ALL_DIRTY;
+}
+
+void render_time (struct render *r, const unsigned int secs)
+{
+	struct clock *clock = &r->clock;
+
+	if (secs == clock->secs + 1) { clock_advance(clock); }
+	else if (secs + 1 == clock->secs) { clock_retreat(clock); }
+	else if (secs != clock->secs) { clock_set(clock, secs); }
+
+	for (unsigned short d = 0; d < CLOCK_DIGITS; d++)
+		if (clock->dirty & (1 << d)) draw_glyph(&r->frame, &r->glyphs, DigitSlot[d], clock->digits[d]);
+
+	clock->dirty = 0;
+}
+
+void render_state (struct render *r, const enum state state)
+{
+	r->state = state;
+	put_state(&r->frame, r->font, r->ori_y, r->ori_x, state);
+}
+
+static void clock_set (struct clock *clock, const unsigned int secs)
+{
+	const unsigned int hur = secs / 3600 % 100, min = secs / 60 % 60, sec = secs % 60;
+	const unsigned char digits[CLOCK_DIGITS] = { hur / 10, hur % 10, min / 10, min % 10, sec / 10, sec % 10 };
+
+	for (unsigned short d = 0; d < CLOCK_DIGITS; d++)
+	{
+		if (clock->digits[d] != digits[d]) clock->dirty |= 1 << d;
+		clock->digits[d] = digits[d];
+	}
+	clock->secs = secs;
+}
+
+static void clock_advance (struct clock *clock)
+{
+	clock->secs++;
+
+	/* ss -> mm -> hh, the tens of minutes and seconds wrap at 5 and
+	 * hours wrap at 99, nine seconds out of ten only touch one digit
+	 */
+	for (short d = CLOCK_DIGITS - 1; d >= 0; d--)
+	{
+		clock->dirty |= 1 << d;
+		if (clock->digits[d] < DigitMax[d]) { clock->digits[d]++; return; }
+		clock->digits[d] = 0;
+	}
+}
+
+static void clock_retreat (struct clock *clock)
+{
+	clock->secs--;
+
+	/* counting down (time left) borrows the very same way */
+	for (short d = CLOCK_DIGITS - 1; d >= 0; d--)
+	{
+		clock->dirty |= 1 << d;
+		if (clock->digits[d] > 0) { clock->digits[d]--; return; }
+		clock->digits[d] = DigitMax[d];
+	}
+}
+
+void render_free (struct render *r)
+{
+	frame_free(&r->frame);
+	free(r->glyphs.bytes);
+	memset(&r->glyphs, 0, sizeof(r->glyphs));
+}
+
+static void render_constant (struct frame *fr, const struct font_t *font, const unsigned short ori_y, const unsigned ori_x, const char *task)
+{
+	const unsigned short coffset[] =
+	{
+		font->width * 2,
+		font->width * 5,
+	};
+
+	for (unsigned short i = 0; i < 2; i++)
+		for (unsigned short line = 0; line < font->height; line++)
+			put_glyph_row(fr, ori_y + line, ori_x + coffset[i], font, COLON_INDEX, line, FRAME_ATTR_BLINK);
+
+	const unsigned short loffset = ori_y + font->height + 2;
+	static const char working[] = "working on ", hint[] = "press 'q' to save & quit", state[] = "state: ";
+
+	frame_puts(fr, loffset + 0, ori_x, working, sizeof(working) - 1, FRAME_ATTR_NONE);
+	frame_puts(fr, loffset + 0, ori_x + sizeof(working) - 1, task, strlen(task), FRAME_ATTR_BOLD);
+	frame_puts(fr, loffset + 1, ori_x, hint, sizeof(hint) - 1, FRAME_ATTR_DIM);
+	frame_puts(fr, loffset + 2, ori_x, state, sizeof(state) - 1, FRAME_ATTR_NONE);
+}
+
+static void put_state (struct frame *fr, const struct font_t *font, const unsigned short ori_y, const unsigned short ori_x, const enum state state)
+{
+	static const char label[] = "state: ";
+	frame_puts(fr, ori_y + font->height + 4, ori_x + sizeof(label) - 1, States[state], strlen(States[state]), FRAME_ATTR_NONE);
+}
+
+static void build_glyph_cache (struct glyph_cache *gc, const struct font_t *font, const unsigned short ori_y, const unsigned short ori_x)
+{
+	/* the spans are still valid as long as the origin did not move */
+	if (gc->bytes && gc->font == font && gc->ori_y == ori_y && gc->ori_x == ori_x) return;
+
+	gc->font  = font;
+	gc->ori_y = ori_y;
+	gc->ori_x = ori_x;
+
+	size_t len = 0;
+	const size_t cap = (sizeof("\x1b[65535;65535H") + font->width) * font->height * FONT_CHARSET_SIZE * RENDER_CHARSET_SIZE;
+	char *bytes;
+
+	bytes = gc->bytes = (char*) realloc(gc->bytes, cap);
+	if (bytes == NULL)
+	{
+		fprintf(stderr, "%s: error: out of memory\n", PROGRAM_NAME);
+		exit(EXIT_FAILURE);
+	}
+
+	for (unsigned short glyph = 0; glyph < FONT_CHARSET_SIZE; glyph++)
+		for (unsigned short slot = 0; slot < RENDER_CHARSET_SIZE; slot++)
+		{
+			gc->offs[glyph][slot] = len;
+			for (unsigned short line = 0; line < font->height; line++)
+			{
+				const unsigned short rlen = font_row_len(font, glyph, line);
+
+				len += sprintf(bytes + len, "\x1b[%d;%dH", ori_y + line + 1, ori_x + slot * font->width + 1);
+				memcpy(bytes + len, font_row(font, glyph, line), rlen);
+				memset(bytes + len + rlen, ' ', font->width - rlen);
+				len += font->width;
+			}
+			gc->lens[glyph][slot] = len - gc->offs[glyph][slot];
+		}
+}
+
+static void draw_glyph (struct frame *fr, struct glyph_cache *gc, const unsigned short slot, const unsigned short glyph)
+{
+	const struct font_t *font = gc->font;
+	const unsigned short x    = gc->ori_x + slot * font->width;
+
+	for (unsigned short line = 0; line < font->height; line++)
+		put_glyph_row(fr, gc->ori_y + line, x, font, glyph, line, FRAME_ATTR_NONE);
+
+	/* a stale screen is going to be redrawn from scratch anyway */
+	if (fr->stale) return;
+
+	frame_emit(fr, gc->bytes + gc->offs[glyph][slot], gc->lens[glyph][slot]);
+	for (unsigned short line = 0; line < font->height; line++)
+		frame_mark(fr, gc->ori_y + line, x, font->width);
+}
+
+static void put_glyph_row (struct frame *fr, const unsigned short y, const unsigned short x, const struct font_t *font, const unsigned short glyph, const unsigned short line, const unsigned char attr)
+{
+	/* rows of loaded fonts may be narrower than the font itself,
+	 * whatever was there before must be wiped
+	 */
+	const unsigned short len = font_row_len(font, glyph, line);
+	frame_puts(fr, y, x, font_row(font, glyph, line), len, attr);
+	if (len < font->width) frame_fill(fr, y, x + len, font->width - len);
+}
@@ -0,0 +1,84 @@
+#ifndef FT_RENDER_H
+#define FT_RENDER_H
+
+#include "common.h"
+#include "frame.h"
+#include "font.h"
+
+/* Number of characters defined within a font_t
+ * to be displayed in screen xx:xx:xx (8)
+ */
+#define RENDER_CHARSET_SIZE    8
+/* Besides the time left/passed we need to display
+ * other information, this number indicates how many
+ * lines are going to be used
+ */
+#define EXTRA_RENDERED_LINES   3
+
+enum state
+{
+	state_wkg = 0,
+	state_psd = 1,
+};
+
+/* besides of saying what type of metric is, it also provides
+ * the offset at which the value should be rendered
+ * hh:mm:ss
+ * |  |  ` sixth one
+ * |  ` third character to be redered
+ * 0 offset
+ */
+enum temps
+{
+	temps_hur = 0,
+	temps_min = 3,
+	temps_sec = 6,
+};
+
+/* Every (glyph, slot) pair fully encoded as it must be sent to the
+ * terminal (cursor movement + row, for every row), built only when
+ * the rendering origin changes so a tick just concatenates spans
+ */
+struct glyph_cache
+{
+	const struct font_t *font;
+	char                *bytes;
+	unsigned int        offs[FONT_CHARSET_SIZE][RENDER_CHARSET_SIZE];
+	unsigned int        lens[FONT_CHARSET_SIZE][RENDER_CHARSET_SIZE];
+	unsigned short      ori_y, ori_x;
+};
+
+#define CLOCK_DIGITS           6
+#define CLOCK_ALL_DIRTY        ((1 << CLOCK_DIGITS) - 1)
+
+/* hh:mm:ss kept as separate digits (most significant first) so the
+ * usual one second step is a carry over a few digits, 'dirty' has a
+ * bit per digit that changed since it was last drawn
+ */
+struct clock
+{
+	unsigned int  secs;
+	unsigned char digits[CLOCK_DIGITS];
+	unsigned char dirty;
+};
+
+/* Everything needed to turn the timer state into terminal output,
+ * it knows nothing about where the bytes end up (see frame.h)
+ */
+struct render
+{
+	struct frame        frame;
+	struct glyph_cache  glyphs;
+	struct clock        clock;
+	const struct font_t *font;
+	const char          *task;
+	enum state          state;
+	unsigned short      ori_y, ori_x;
+};
+
+void render_layout (struct render*, const unsigned short, const unsigned short);
+void render_time (struct render*, const unsigned int);
+void render_state (struct render*, const enum state);
+void render_free (struct render*);
+
+#endif
@@ -0,0 +1,180 @@
+#include "screen.h"
+
+#include <poll.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+static void nudge (const int);
+static void *draw_loop (void*);
+static const struct view *take (struct screen*);
+static void paint (struct screen*, const struct view*, uint32_t*);
+
+bool_t screen_start (struct screen *screen, const int fd)
+{
+	screen->back  = 0;
+	screen->front = 2;
+	atomic_init(&screen->middle, 1);
+	atomic_init(&screen->stop, FALSE);
+
+	screen->probes.render  = (struct hist) { .name = "render",        .unit = "ns"    };
+	screen->probes.written = (struct hist) { .name = "frame size",    .unit = "bytes" };
+	screen->probes.blocked = (struct hist) { .name = "blocked write", .unit = "ns"    };
+	pthread_mutex_init(&screen->lock, NULL);
+
+	screen->fd   = fd;
+	screen->wake = eventfd(0, EFD_CLOEXEC);
+	if (screen->wake == -1) return FALSE;
+
+	/* a terminal which cannot keep up gets the newest frame only
+	 * (see frame_supersede) instead of a backlog of old ones, the
+	 * flags are the caller's to give back (the open file description
+	 * is most likely shared with stdin and the shell)
+	 */
+	const int flags = fcntl(fd, F_GETFL);
+	if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+	{
+		close(screen->wake);
+		return FALSE;
+	}
+
+	/* the signals are blocked already (see intro_) and so they are
+	 * here, they all end up in the timer's signalfd
+	 */
+	if (pthread_create(&screen->thread, NULL, draw_loop, screen))
+	{
+		close(screen->wake);
+		return FALSE;
+	}
+
+	screen->running = TRUE;
+	return TRUE;
+}
+
+void screen_publish (struct screen *screen, const struct view *view)
+{
+	screen->slots[screen->back] = *view;
+	screen->back = atomic_exchange_explicit(&screen->middle, screen->back | SCREEN_SLOT_FRESH, memory_order_acq_rel) & SCREEN_SLOT_INDEX;
+	nudge(screen->wake);
+}
+
+void screen_read_probes (struct screen *screen, struct screen_probes *copy)
+{
+	pthread_mutex_lock(&screen->lock);
+	*copy = screen->probes;
+	pthread_mutex_unlock(&screen->lock);
+}
+
+void screen_stop (struct screen *screen)
+{
+	if (!screen->running) return;
+
+	/* whatever was published last still gets drawn (see draw_loop) */
+	atomic_store(&screen->stop, TRUE);
+	nudge(screen->wake);
+
+	pthread_join(screen->thread, NULL);
+	close(screen->wake);
+
+	render_free(&screen->render);
+	screen->running = FALSE;
+}
+
+static void nudge (const int wake)
+{
+	/* an eventfd counter cannot realistically overflow, the write
+	 * never blocks
+	 */
+	const uint64_t one = 1;
+	while (write(wake, &one, sizeof(one)) == -1 && errno == EINTR);
+}
+
+static void *draw_loop (void *arg)
+{
+	struct screen *screen = (struct screen*) arg;
+	struct frame  *fr     = &screen->render.frame;
+	uint32_t layout = 0;
+	uint64_t wakeups;
+	int64_t  giveup = 0;
+
+	for (;;)
+	{
+		const bool_t stop = atomic_load(&screen->stop);
+
+		/* any number of views may have been published since the
+		 * last frame, only the newest one is drawn
+		 */
+		const struct view *view = take(screen);
+		if (view) paint(screen, view, &layout);
+
+		/* whatever is on its way out is finished before leaving,
+		 * the terminal is about to be given back, unless it does
+		 * not take it within SCREEN_DRAIN_NS
+		 */
+		if (stop && !frame_pending(fr)) break;
+
+		struct pollfd fds[2] =
+		{
+			{ .fd = screen->fd,   .events = POLLOUT },
+			{ .fd = screen->wake, .events = POLLIN  },
+		};
+		const bool_t busy = frame_pending(fr);
+		int timeout = -1;
+
+		if (stop)
+		{
+			const int64_t now = tick_now();
+			if (giveup == 0) giveup = now + SCREEN_DRAIN_NS;
+			if (now >= giveup) break;
+			timeout = (int) ((giveup - now + 999999) / 1000000);
+		}
+
+		if (poll(fds + !busy, 1 + (busy && !stop), timeout) == -1) continue;
+
+		if (busy && fds[0].revents) frame_drain(fr, screen->fd);
+		if (fds[1].revents & POLLIN) { while (read(screen->wake, &wakeups, sizeof(wakeups)) == -1 && errno == EINTR); }
+	}
+
+	return NULL;
+}
+
+static const struct view *take (struct screen *screen)
+{
+	if (!(atomic_load_explicit(&screen->middle, memory_order_relaxed) & SCREEN_SLOT_FRESH)) return NULL;
+
+	screen->front = atomic_exchange_explicit(&screen->middle, screen->front, memory_order_acq_rel) & SCREEN_SLOT_INDEX;
+	return &screen->slots[screen->front];
+}
+
+static void paint (struct screen *screen, const struct view *view, uint32_t *layout)
+{
+	struct render *r  = &screen->render;
+	struct frame  *fr = &r->frame;
+
+	const uint64_t sent  = fr->bytes;
+	const int64_t  begin = tick_now();
+
+	frame_supersede(fr);
+
+	if (view->layout != *layout)
+	{
+		r->font  = view->font;
+		r->task  = view->task;
+		r->state = view->state;
+		render_layout(r, view->height, view->width);
+		*layout  = view->layout;
+	}
+	else if (view->state != r->state) { render_state(r, view->state); }
+
+	render_time(r, view->secs);
+	frame_flush(fr, screen->fd);
+
+	/* composing and encoding only, the write is measured apart */
+	pthread_mutex_lock(&screen->lock);
+	hist_record(&screen->probes.render, tick_now() - begin - fr->blocked);
+	hist_record(&screen->probes.written, (int64_t) (fr->bytes - sent));
+	hist_record(&screen->probes.blocked, fr->blocked);
+	screen->probes.dropped = fr->dropped;
+	pthread_mutex_unlock(&screen->lock);
+}
@@ -0,0 +1,73 @@
+#ifndef FT_SCREEN_H
+#define FT_SCREEN_H
+
+#include "common.h"
+#include "render.h"
+#include "hist.h"
+#include "tick.h"
+
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/* Terminal output lives on a thread of its own so a stalled terminal
+ * (a frozen ssh session, a tmux pane in copy mode) can never hold the
+ * timer back: the timer publishes what should be on screen and moves
+ * on, the screen thread draws whatever is the latest when it gets to it
+ */
+
+/* What the screen should show, published as a whole every time
+ * something changes, 'layout' is bumped whenever the screen has to be
+ * laid out again (resize, another font or task)
+ */
+struct view
+{
+	const struct font_t *font;
+	const char          *task;
+	unsigned int        secs;
+	enum state          state;
+	unsigned short      height, width;
+	uint32_t            layout;
+};
+
+/* Single producer single consumer slot (triple buffer): the producer
+ * writes its own slot and swaps it with the shared one, the consumer
+ * swaps its own with the shared one only when that one is fresh. No
+ * side ever waits for the other and stale views are simply overwritten
+ */
+#define SCREEN_SLOT_INDEX      0x3
+#define SCREEN_SLOT_FRESH      0x4
+
+/* How long screen_stop waits for the last frame to get out, a
+ * terminal nobody reads from any more would hold it back forever
+ */
+#define SCREEN_DRAIN_NS        (NS_PER_SEC / 2)
+
+struct screen_probes
+{
+	struct hist render, written, blocked;
+	uint64_t    dropped;
+};
+
+struct screen
+{
+	struct view          slots[3];
+	unsigned char        back, front;
+	_Atomic unsigned char middle;
+	_Atomic bool_t       stop;
+	/* eventfd the screen thread sleeps on */
+	int                  wake, fd;
+	bool_t               running;
+	pthread_t            thread;
+	struct render        render;
+	/* only ever taken to record or copy the probes */
+	pthread_mutex_t      lock;
+	struct screen_probes probes;
+};
+
+bool_t screen_start (struct screen*, const int);
+void screen_publish (struct screen*, const struct view*);
+void screen_read_probes (struct screen*, struct screen_probes*);
+void screen_stop (struct screen*);
+
+#endif
@@ -0,0 +1,204 @@
+#include "status.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static bool_t read_page (const int, const char*, struct status_page*);
+static void print_status (const struct status_page*, const char*);
+static void print_secs (const unsigned int);
+static int cmp_pid (const void*, const void*);
+
+static inline void write_begin (struct status_page *page)
+{
+	const uint32_t seq = atomic_load_explicit(&page->seq, memory_order_relaxed);
+	atomic_store_explicit(&page->seq, seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+}
+
+static inline void write_end (struct status_page *page)
+{
+	const uint32_t seq = atomic_load_explicit(&page->seq, memory_order_relaxed);
+	atomic_store_explicit(&page->seq, seq + 1, memory_order_release);
+}
+
+bool_t status_open (struct status_map *map)
+{
+	char temp[sizeof(map->path)];
+	snprintf(map->path, sizeof(map->path), "%s%s%u.%d", STATUS_DIR, STATUS_PREFIX, (unsigned int) getuid(), (int) getpid());
+	snprintf(temp, sizeof(temp), "%s.%s%u.%d", STATUS_DIR, STATUS_PREFIX, (unsigned int) getuid(), (int) getpid());
+
+	/* the page is built apart and only then renamed into place, a
+	 * reader never sees it half done and nobody else's file is ever
+	 * taken over (the one left by an earlier 4T of this pid may go)
+	 */
+	map->page = NULL;
+	int fd = open(temp, O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+	if (fd == -1 && errno == EEXIST && unlink(temp) == 0)
+	{
+		fd = open(temp, O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+	}
+	if (fd == -1) return FALSE;
+
+	/* the mapping is all that is needed from now on */
+	void *data = MAP_FAILED;
+	if (ftruncate(fd, sizeof(struct status_page)) == 0)
+	{
+		data = mmap(NULL, sizeof(struct status_page), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		unlink(temp);
+		return FALSE;
+	}
+
+	struct status_page *page = (struct status_page*) data;
+	page->magic   = STATUS_MAGIC;
+	page->version = STATUS_VER;
+	page->pid     = (int32_t) getpid();
+
+	if (rename(temp, map->path) == -1)
+	{
+		munmap(data, sizeof(struct status_page));
+		unlink(temp);
+		return FALSE;
+	}
+
+	map->page = page;
+	return TRUE;
+}
+
+void status_publish (struct status_map *map, const char *task, const enum status_state state, const unsigned int worked, const unsigned int total)
+{
+	struct status_page *page = map->page;
+	if (page == NULL) return;
+
+	write_begin(page);
+	page->state  = state;
+	page->worked = worked;
+	page->total  = total;
+	strncpy(page->task, task, STATUS_TASK_SIZE - 1);
+	write_end(page);
+}
+
+void status_close (struct status_map *map)
+{
+	if (map->page == NULL) return;
+
+	munmap(map->page, sizeof(struct status_page));
+	unlink(map->path);
+	map->page = NULL;
+}
+
+int status_query (const char *format)
+{
+	char prefix[32];
+	const int plen = snprintf(prefix, sizeof(prefix), "%s%u.", STATUS_PREFIX, (unsigned int) getuid());
+
+	DIR *dir = opendir(STATUS_DIR);
+	if (dir == NULL) return EXIT_FAILURE;
+
+	struct status_page *pages = NULL;
+	size_t n = 0, cap = 0;
+
+	struct dirent *ent;
+	while ((ent = readdir(dir)) != NULL)
+	{
+		if (strncmp(ent->d_name, prefix, (size_t) plen)) continue;
+
+		if (n == cap)
+		{
+			cap   = cap ? cap << 1 : 4;
+			pages = (struct status_page*) realloc(pages, cap * sizeof(struct status_page));
+			if (pages == NULL)
+			{
+				fprintf(stderr, "%s: error: out of memory\n", PROGRAM_NAME);
+				exit(EXIT_FAILURE);
+			}
+		}
+		if (read_page(dirfd(dir), ent->d_name, &pages[n])) n++;
+	}
+	closedir(dir);
+
+	/* same order on every refresh of a status bar */
+	qsort(pages, n, sizeof(struct status_page), cmp_pid);
+	for (size_t i = 0; i < n; i++) print_status(&pages[i], format);
+
+	free(pages);
+	return n ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static bool_t read_page (const int dirfd, const char *name, struct status_page *copy)
+{
+	const int fd = openat(dirfd, name, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if (fd == -1) return FALSE;
+
+	/* /dev/shm is anybody's, a page of someone else's is not looked
+	 * at and a short one would fault (SIGBUS) past its end
+	 */
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_uid != getuid() || (size_t) st.st_size < sizeof(struct status_page))
+	{
+		close(fd);
+		return FALSE;
+	}
+
+	void *data = mmap(NULL, sizeof(struct status_page), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) return FALSE;
+
+	const bool_t ok = status_read((const struct status_page*) data, copy);
+	munmap(data, sizeof(struct status_page));
+
+	/* left behind by a timer which did not get to clean up */
+	if (ok && kill(copy->pid, 0) == -1 && errno == ESRCH)
+	{
+		unlinkat(dirfd, name, 0);
+		return FALSE;
+	}
+	return ok;
+}
+
+static void print_status (const struct status_page *page, const char *format)
+{
+	const unsigned int left = page->total > page->worked ? page->total - page->worked : 0;
+
+	for (const char *c = format; *c; c++)
+	{
+		if (*c != '%' || c[1] == '\0') { putchar(*c); continue; }
+
+		switch (*++c)
+		{
+			case 't': fputs(page->task, stdout); break;
+			case 's': fputs(page->state == status_paused ? "paused" : "working", stdout); break;
+			case 'w': print_secs(page->worked); break;
+			case 'l': print_secs(left); break;
+			case 'T': print_secs(page->total); break;
+			case 'p': printf("%d", (int) page->pid); break;
+			default : putchar(*c); break;
+		}
+	}
+	putchar('\n');
+}
+
+static void print_secs (const unsigned int secs)
+{
+	/* mm:ss, hours only when there are any */
+	if (secs >= 3600) printf("%u:%02u:%02u", secs / 3600, secs / 60 % 60, secs % 60);
+	else printf("%02u:%02u", secs / 60, secs % 60);
+}
+
+static int cmp_pid (const void *a, const void *b)
+{
+	const int32_t x = ((const struct status_page*) a)->pid, y = ((const struct status_page*) b)->pid;
+	return (x > y) - (x < y);
+}
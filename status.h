@@ -0,0 +1,84 @@
+#ifndef FT_STATUS_H
+#define FT_STATUS_H
+
+#include "common.h"
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+/* Every running timer publishes its state on a page of its own under
+ * /dev/shm (status bars, prompts, --status), named after the user and
+ * the process so several timers never share one
+ */
+#define STATUS_DIR         "/dev/shm/"
+#define STATUS_PREFIX      "4T-status."
+#define STATUS_MAGIC       0x34545354u
+#define STATUS_VER         1
+#define STATUS_TASK_SIZE   64
+
+/* --status line for every running timer, '%t' task, '%s' state,
+ * '%w' worked, '%l' left, '%T' total, '%p' pid and '%%' itself
+ */
+#define STATUS_FORMAT      "%t %l left"
+
+enum status_state
+{
+	status_working = 0,
+	status_paused  = 1,
+};
+
+/* Guarded by a seqlock: 'seq' is odd while the writer is in the
+ * middle of an update, a reader copies the page and keeps the copy
+ * only if 'seq' was even and did not move meanwhile. The writer never
+ * waits and a reader never makes a syscall
+ */
+struct status_page
+{
+	uint32_t         magic, version;
+	_Atomic uint32_t seq;
+	int32_t          pid;
+	uint32_t         state;
+	uint32_t         worked, total;
+	char             task[STATUS_TASK_SIZE];
+};
+
+struct status_map
+{
+	struct status_page *page;
+	char               path[64];
+};
+
+bool_t status_open (struct status_map*);
+void status_publish (struct status_map*, const char*, const enum status_state, const unsigned int, const unsigned int);
+void status_close (struct status_map*);
+
+int status_query (const char*);
+
+static inline bool_t status_read (const struct status_page *page, struct status_page *copy)
+{
+	/* a writer killed halfway leaves 'seq' odd forever, hence the
+	 * bounded number of attempts
+	 */
+	for (unsigned short attempt = 0; attempt < 1024; attempt++)
+	{
+		const uint32_t seq = atomic_load_explicit(&page->seq, memory_order_acquire);
+		if (seq & 1) continue;
+
+		copy->magic   = page->magic;
+		copy->version = page->version;
+		copy->pid     = page->pid;
+		copy->state   = page->state;
+		copy->worked  = page->worked;
+		copy->total   = page->total;
+		for (unsigned short i = 0; i < STATUS_TASK_SIZE; i++) copy->task[i] = page->task[i];
+
+		atomic_thread_fence(memory_order_acquire);
+		if (atomic_load_explicit(&page->seq, memory_order_relaxed) != seq) continue;
+
+		copy->task[STATUS_TASK_SIZE - 1] = '\0';
+		return copy->magic == STATUS_MAGIC && copy->version == STATUS_VER;
+	}
+	return FALSE;
+}
+
+#endif
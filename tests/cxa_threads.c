@@ -0,0 +1,164 @@
+/* Every thread parses its own arguments over a context and flags of
+ * its own, meant to be built with -fsanitize=thread (make test) so any
+ * state shared between contexts shows up as a race
+ */
+#include "../cxa.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define THREADS    8
+#define ROUNDS     2000
+
+static void *parse_loop (void*);
+static int expect_error (const int, char**, const int);
+static int reuse_context (void);
+
+static int Failures = 0;
+static pthread_mutex_t Lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void failed (const char *what, const long id)
+{
+	pthread_mutex_lock(&Lock);
+	fprintf(stderr, "cxa_threads: thread %ld: %s\n", id, what);
+	Failures++;
+	pthread_mutex_unlock(&Lock);
+}
+
+int main (void)
+{
+	pthread_t threads[THREADS];
+
+	for (long i = 0; i < THREADS; i++)
+	{
+		if (pthread_create(&threads[i], NULL, parse_loop, (void*) i))
+		{
+			fprintf(stderr, "cxa_threads: cannot start thread %ld\n", i);
+			return EXIT_FAILURE;
+		}
+	}
+	for (unsigned short i = 0; i < THREADS; i++) pthread_join(threads[i], NULL);
+
+	/* wrong arguments come back as errors, the process lives on */
+	char *shortname[] = { "t", "-z" };
+	char *longname[]  = { "t", "--nope" };
+	char *missing[]   = { "t", "--count" };
+	char *multi[]     = { "t", "-cn", "1" };
+	char *response[]  = { "t", "@/nonexistent/cxa_threads" };
+
+	Failures += expect_error(2, shortname, CXA_ERR_SHORTNAME);
+	Failures += expect_error(2, longname, CXA_ERR_LONGNAME);
+	Failures += expect_error(2, missing, CXA_ERR_MISSING_ARG);
+	Failures += expect_error(3, multi, CXA_ERR_MULTI_TAKER);
+	Failures += expect_error(2, response, CXA_ERR_RESPONSE_FILE);
+	Failures += reuse_context();
+
+	if (Failures) return EXIT_FAILURE;
+	puts("cxa_threads: ok");
+	return EXIT_SUCCESS;
+}
+
+static void *parse_loop (void *arg)
+{
+	const long id = (long) arg;
+
+	char *name = NULL;
+	int count  = 0;
+
+	struct CxaFlag flags[] =
+	{
+		CXA_SET_STR("name",    "a name",   &name,    CXA_FLAG_TAKER_YES, 'n'),
+		CXA_SET_INT("count",   "a number", &count,   CXA_FLAG_TAKER_YES, 'c'),
+		CXA_SET_CHR("verbose", "a switch", NULL,     CXA_FLAG_TAKER_NON, 'v'),
+		CXA_SET_END
+	};
+
+	char given[16], number[16];
+	snprintf(given, sizeof(given), "thread-%ld", id);
+
+	struct CxaContext ctx;
+	cxa_init_ctx(&ctx, flags, NULL, "cxa_threads");
+
+	for (int round = 0; round < ROUNDS; round++)
+	{
+		snprintf(number, sizeof(number), "%ld", id * ROUNDS + round);
+		char *argv[] = { "t", "-v", "--name", given, "-c", number, "left", "--", "-right" };
+
+		count = 0;
+		name  = NULL;
+
+		struct Cxa *cxa = cxa_execute_ctx(&ctx, sizeof(argv) / sizeof(argv[0]), argv);
+		if (cxa == NULL) { failed(ctx.message, id); break; }
+
+		if (name == NULL || strcmp(name, given)) failed("wrong --name", id);
+		if (count != id * ROUNDS + round) failed("wrong --count", id);
+		if (!(flags[2].meta & CXA_FLAG_SEEN_MASK)) failed("-v not seen", id);
+		if (cxa->len != 2 || strcmp(cxa->positional[0], "left") || strcmp(cxa->positional[1], "-right")) failed("wrong positionals", id);
+
+		cxa_clean(cxa);
+	}
+	return NULL;
+}
+
+static int expect_error (const int argc, char **argv, const int error)
+{
+	char *name = NULL;
+	int count  = 0;
+
+	struct CxaFlag flags[] =
+	{
+		CXA_SET_STR("name",  "a name",   &name,  CXA_FLAG_TAKER_YES, 'n'),
+		CXA_SET_INT("count", "a number", &count, CXA_FLAG_TAKER_YES, 'c'),
+		CXA_SET_END
+	};
+
+	struct CxaContext ctx;
+	cxa_init_ctx(&ctx, flags, NULL, "cxa_threads");
+
+	struct Cxa *cxa = cxa_execute_ctx(&ctx, argc, argv);
+	if (cxa == NULL && ctx.error == error && ctx.message[0]) return 0;
+
+	fprintf(stderr, "cxa_threads: '%s' gave error %d instead of %d\n", argv[1], ctx.error, error);
+	if (cxa) cxa_clean(cxa);
+	return 1;
+}
+
+static int reuse_context (void)
+{
+	char *name = NULL;
+
+	struct CxaFlag flags[] =
+	{
+		CXA_SET_STR("name",    "a name",   &name, CXA_FLAG_TAKER_YES, 'n'),
+		CXA_SET_CHR("verbose", "a switch", NULL,  CXA_FLAG_TAKER_NON, 'v'),
+		CXA_SET_END
+	};
+
+	struct CxaContext ctx;
+	cxa_init_ctx(&ctx, flags, NULL, "cxa_threads");
+
+	/* nothing the first parse saw may leak into the next ones */
+	char *first[]  = { "t", "-v", "--name", "x" };
+	char *second[] = { "t", "--name" };
+	char *third[]  = { "t" };
+
+	struct Cxa *cxa = cxa_execute_ctx(&ctx, 4, first);
+	if (cxa == NULL || !(flags[1].meta & CXA_FLAG_SEEN_MASK)) goto fail;
+	cxa_clean(cxa);
+
+	if ((cxa = cxa_execute_ctx(&ctx, 2, second)) != NULL || ctx.error != CXA_ERR_MISSING_ARG) goto fail;
+
+	if ((cxa = cxa_execute_ctx(&ctx, 1, third)) == NULL) goto fail;
+	cxa_clean(cxa);
+
+	if ((flags[0].meta | flags[1].meta) & (CXA_FLAG_SEEN_MASK | CXA_FLAG_ARG_GIVEN_MASK)) goto fail;
+	return 0;
+
+fail:
+	fprintf(stderr, "cxa_threads: a reused context kept the last parse's flags\n");
+	if (cxa) cxa_clean(cxa);
+	return 1;
+}
@@ -0,0 +1,87 @@
+#include "tick.h"
+
+#include <time.h>
+#include <sys/prctl.h>
+
+int64_t tick_now (void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * NS_PER_SEC + ts.tv_nsec;
+}
+
+void tick_start (struct tick *tick, const int64_t period, const uint64_t done)
+{
+	/* (re)starting drops whatever expired before, the grid is laid
+	 * as if 'done' periods had already gone by
+	 */
+	tick->origin    = tick_now() - (int64_t) done * period;
+	tick->period    = period;
+	tick->deadline  = tick->origin + (int64_t) done * period;
+	tick->late      = 0;
+	tick->paused_at = 0;
+	tick->paused    = 0;
+	tick->count     = done;
+
+	/* slack only applies to this thread's sleeps, a failure just
+	 * means the default (50us) is kept
+	 */
+	prctl(PR_SET_TIMERSLACK, (unsigned long) (period >> TICK_SLACK_SHIFT), 0, 0, 0);
+}
+
+int tick_timeout (const struct tick *tick)
+{
+	/* nothing visible changes until the timer is resumed, so there
+	 * is no reason to wake up at all
+	 */
+	if (tick->paused_at) { return -1; }
+
+	/* rounded up, waking before the deadline would only mean going
+	 * back to sleep right away
+	 */
+	const int64_t next = tick->origin + (int64_t) (tick->count + 1) * tick->period;
+	const int64_t wait = next - tick_now();
+
+	return wait > 0 ? (int) ((wait + NS_PER_MS - 1) / NS_PER_MS) : 0;
+}
+
+uint64_t tick_consume (struct tick *tick)
+{
+	if (tick->paused_at) { return 0; }
+
+	/* deadlines come from the grid, never from the wakeup itself, so
+	 * a late one is not carried over to the next
+	 */
+	const int64_t  now     = tick_now();
+	const uint64_t reached = now > tick->origin ? (uint64_t) ((now - tick->origin) / tick->period) : 0;
+	if (reached <= tick->count) { return 0; }
+
+	const uint64_t expired = reached - tick->count;
+
+	tick->count    = reached;
+	tick->deadline = tick->origin + (int64_t) tick->count * tick->period;
+	tick->late     = now - tick->deadline;
+
+	return expired;
+}
+
+void tick_pause (struct tick *tick)
+{
+	if (tick->paused_at) { return; }
+	tick->paused_at = tick_now();
+}
+
+void tick_resume (struct tick *tick)
+{
+	if (!tick->paused_at) { return; }
+
+	/* the grid is shifted by the pause so the part of a second
+	 * already worked before pausing is not lost nor counted twice
+	 */
+	const int64_t pause = tick_now() - tick->paused_at;
+
+	tick->origin   += pause;
+	tick->deadline += pause;
+	tick->paused   += pause;
+	tick->paused_at = 0;
+}
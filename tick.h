@@ -0,0 +1,44 @@
+#ifndef FT_TICK_H
+#define FT_TICK_H
+
+#include <stdint.h>
+
+#define NS_PER_SEC 1000000000LL
+#define NS_PER_MS  1000000LL
+
+/* How late the kernel may end a sleep so it can be coalesced with
+ * other wakeups, as a fraction of the period (1/64 ~ 15ms per second)
+ * it only delays the redraw, never the time being measured. Timer
+ * slack is honoured by sleeping syscalls (epoll_wait, nanosleep) but
+ * not by timerfd, hence ticks are waited for with tick_timeout
+ */
+#define TICK_SLACK_SHIFT 6
+
+/* Ticks are scheduled against absolute CLOCK_MONOTONIC deadlines
+ * (origin + k * period) so no matter how long the loop takes between
+ * wakeups the schedule never drifts, elapsed time is always derived
+ * from timestamps and never from the number of wakeups
+ */
+struct tick
+{
+	int64_t  origin, period;
+	/* deadline of the last tick consumed and how late (ns) the
+	 * wakeup landed with respect to it (see the lateness probe)
+	 */
+	int64_t  deadline, late;
+	/* while paused the timer is disarmed, 'paused' adds up every
+	 * pause so far and the origin is moved forward by each of them
+	 */
+	int64_t  paused_at, paused;
+	uint64_t count;
+};
+
+int64_t tick_now (void);
+
+void tick_start (struct tick*, const int64_t, const uint64_t);
+int tick_timeout (const struct tick*);
+uint64_t tick_consume (struct tick*);
+void tick_pause (struct tick*);
+void tick_resume (struct tick*);
+
+#endif
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Generates flagset.h out of the CXA_SET_* definitions of a source file
+# usage: tools/mkflagset.py main.c > flagset.h
+#
+# Flags are taken in the order they are defined (which is their index
+# within the CxaFlag array), repeated long or short names are rejected
+# here so cxa does not need to look for them every time it runs
+
+import re
+import sys
+
+from phash import perfect_hash
+
+FLAG = re.compile(r'CXA_SET_[A-Z]{3}\(\s*"([^"]+)"\s*,.*,\s*\'(.)\'\s*\)')
+
+def read_flags (path):
+	with open(path) as f:
+		flags = FLAG.findall(f.read())
+
+	for what, names in (("long", [l for l, _ in flags]), ("short", [s for _, s in flags])):
+		seen = set()
+		for name in names:
+			if name in seen: sys.exit("%s: repeated %s name '%s'" % (path, what, name))
+			seen.add(name)
+
+	return [l for l, _ in flags]
+
+def main (path):
+	names = read_flags(path)
+	disps, slots = perfect_hash(names)
+
+	print("#ifndef FT_FLAGSET_H")
+	print("#define FT_FLAGSET_H")
+	print()
+	print("/* Perfect hash over the long names of the flags defined in %s" % path)
+	print(" * generated by tools/mkflagset.py, do not edit by hand")
+	print(" */")
+	print()
+	print("#define FLAGS_COUNT %d" % len(names))
+	print()
+	for i, name in enumerate(names):
+		print("/* %2d: %s */" % (i, name))
+	print()
+	print("static const unsigned int FlagDisp[%d] = { %s };" % (len(disps), ", ".join(map(str, disps))))
+	print("static const short        FlagSlot[%d] = { %s };" % (len(slots), ", ".join(map(str, slots))))
+	print()
+	print("static const struct CxaHash FlagHash = { FlagDisp, FlagSlot, %d, %d };" % (len(disps), len(slots)))
+	print()
+	print("#endif")
+
+if __name__ == "__main__":
+	main(sys.argv[1])
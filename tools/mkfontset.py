@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# Generates fontset.h out of the font sources found in fonts/
+# usage: tools/mkfontset.py fonts/*.txt > fontset.h
+#
+# A font source starts with a '<height> <width>' line followed by the
+# rows of the 11 glyphs ('0'..'9' and ':'), written the FIGlet way: every
+# row finishes with an endmark ('@') which is doubled on the last row
+# of each glyph
+
+import os
+import sys
+
+from phash import perfect_hash
+
+CHARSET_SIZE = 11
+WIDEST_FONT  = 17
+# glyphs on screen at once (hh:mm:ss), must match FONT_FOOTPRINT_GLYPHS
+SHOWN_GLYPHS = 8
+
+def read_font (path):
+	with open(path) as f:
+		lines = f.read().split("\n")
+
+	height, width = map(int, lines[0].split())
+	rows = []
+
+	for line in lines[1:1 + CHARSET_SIZE * height]:
+		rows.append(line.rstrip(line[-1]) if line else line)
+
+	if len(rows) != CHARSET_SIZE * height or not 0 < height <= WIDEST_FONT:
+		sys.exit("%s: malformed font" % path)
+
+	return height, width, rows
+
+def c_string (row):
+	return '"' + row.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+def emit_font (name, height, width, rows):
+	stride = max(len(r) for r in rows)
+
+	print("static const struct font_t f_%s =" % name)
+	print("{")
+	print("\t.atlas =")
+	for glyph in range(CHARSET_SIZE):
+		print("\t/* '%s' */" % "0123456789:"[glyph])
+		for row in rows[glyph * height:(glyph + 1) * height]:
+			print("\t%s" % c_string(row.ljust(stride)))
+	print("\t,")
+	print("\t.rowlen =")
+	print("\t{")
+	for glyph in range(CHARSET_SIZE):
+		lens = [str(len(r)) for r in rows[glyph * height:(glyph + 1) * height]]
+		print("\t\t{ %s }," % ", ".join(lens))
+	print("\t},")
+	print("\t.height = %d," % height)
+	print("\t.width  = %d," % width)
+	print("\t.stride = %d" % stride)
+	print("};")
+	print()
+
+def main (paths):
+	names = [os.path.splitext(os.path.basename(p))[0] for p in paths]
+	fonts = [read_font(p) for p in paths]
+
+	print("#ifndef FT_FONTSET_H")
+	print("#define FT_FONTSET_H")
+	print()
+	print("/* Font definitions, only meant to be included by font.c")
+	print(" * generated by tools/mkfontset.py, do not edit by hand")
+	print(" */")
+	print()
+	print("#define NO_FONTS %d" % len(names))
+	print()
+
+	for name, font in zip(names, fonts):
+		emit_font(name, *font)
+
+	print("const struct font_entry FontTable[NO_FONTS] =")
+	print("{")
+	for name, (height, width, _) in zip(names, fonts):
+		print("\t{ %-13s &f_%-11s %2d, %2d }," % ('"%s",' % name, name + ",", height, width))
+	print("};")
+	print()
+
+	order = sorted(range(len(names)), key = lambda i: (-fonts[i][0] * fonts[i][1], -fonts[i][0], names[i]))
+
+	print("/* Room every font needs to show hh:mm:ss, largest first */")
+	print("static const struct font_footprint FontFootprint[NO_FONTS] =")
+	print("{")
+	for i in order:
+		print("\t{ %2d, %2d, %3d }, /* %s */" % (i, fonts[i][0], fonts[i][1] * SHOWN_GLYPHS, names[i]))
+	print("};")
+	print()
+
+	disps, slots = perfect_hash(names)
+
+	print("/* Perfect hash over FontTable names */")
+	print("#define FONT_HASH_BUCKETS %d" % len(disps))
+	print("#define FONT_HASH_SIZE    %d" % len(slots))
+	print()
+	print("static const uint32_t FontDisp[FONT_HASH_BUCKETS] = { %s };" % ", ".join(map(str, disps)))
+	print("static const short    FontSlot[FONT_HASH_SIZE]    = { %s };" % ", ".join(map(str, slots)))
+	print()
+	print("#endif")
+
+if __name__ == "__main__":
+	main(sys.argv[1:])
@@ -0,0 +1,34 @@
+# Hash and displace perfect hashing shared by the table generators,
+# must match the FNV-1a flavour used on the C side (font.c, cxa.c)
+
+def fnv1a (name, seed):
+	h = (2166136261 ^ seed) & 0xffffffff
+	for c in name.encode():
+		h ^= c
+		h = (h * 16777619) & 0xffffffff
+	return h
+
+def perfect_hash (names):
+	nbuckets = max(1, len(names) // 2)
+	size     = 1
+	while size < 2 * len(names): size <<= 1
+
+	buckets = [[] for _ in range(nbuckets)]
+	for i, name in enumerate(names):
+		buckets[fnv1a(name, 0) % nbuckets].append(i)
+
+	slots = [-1] * size
+	disps = [0] * nbuckets
+
+	for b in sorted(range(nbuckets), key = lambda b: -len(buckets[b])):
+		if not buckets[b]: continue
+		d = 1
+		while True:
+			idx = [fnv1a(names[i], d) % size for i in buckets[b]]
+			if len(set(idx)) == len(idx) and all(slots[j] == -1 for j in idx):
+				for i, j in zip(buckets[b], idx): slots[j] = i
+				disps[b] = d
+				break
+			d += 1
+
+	return disps, slots